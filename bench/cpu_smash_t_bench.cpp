@@ -0,0 +1,88 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_options.hpp>
+#include <cpu_smash.hpp>
+#include <cpu_smash_t.hpp>
+#ifdef ZERO
+#include <zero_library.hpp>
+#endif  // ZERO
+
+#ifdef ZERO
+namespace {
+
+// Bytes compressed by every measure, in messages of the given size
+const uint64_t kTotalSize{64 * 1024 * 1024};
+
+// Nanoseconds of a compression and a decompression of every message
+template <class Smash>
+double Measure(Smash *compressor, Smash *decompressor,
+               const uint64_t &message_size) {
+  std::vector<char> data(message_size);
+  for (uint64_t i = 0; i < message_size; ++i) {
+    data[i] = (i % 8 < 5) ? 0 : static_cast<char>(i % 251);
+  }
+  CpuOptions options;
+  compressor->SetOptionsCompressor(&options);
+  decompressor->SetOptionsDecompressor(&options);
+  uint64_t compressed_data_size{0};
+  compressor->GetCompressedDataSize(data.data(), message_size,
+                                    &compressed_data_size);
+  std::vector<char> compressed_data(compressed_data_size);
+  std::vector<char> decompressed_data(message_size);
+  const uint64_t messages = kTotalSize / message_size;
+  bool result{true};
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; result && i < messages; ++i) {
+    uint64_t size{compressed_data.size()};
+    uint64_t decompressed_size{message_size};
+    result = compressor->Compress(data.data(), message_size,
+                                  compressed_data.data(), &size) &&
+             decompressor->Decompress(compressed_data.data(), size,
+                                      decompressed_data.data(),
+                                      &decompressed_size);
+  }
+  auto end = std::chrono::steady_clock::now();
+  if (!result) {
+    std::cout << "ERROR: The benchmark failed with messages of "
+              << message_size << " bytes" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         messages;
+}
+
+}  // namespace
+#endif  // ZERO
+
+// Time of CpuSmash and CpuSmashT with the same library. The difference is
+// the cost of the virtual calls, which only shows with small messages
+int main(int argc, char const *argv[]) {
+#ifdef ZERO
+  std::cout << "Message size (bytes)\tCpuSmash (ns)\tCpuSmashT (ns)"
+            << std::endl;
+  for (const uint64_t message_size : {64, 1024, 16 * 1024, 1024 * 1024}) {
+    CpuSmash compressor("zero"), decompressor("zero");
+    CpuSmashT<ZeroLibrary> compressor_t("zero"), decompressor_t("zero");
+    const double time = Measure(&compressor, &decompressor, message_size);
+    const double time_t = Measure(&compressor_t, &decompressor_t,
+                                  message_size);
+    std::cout << message_size << "\t" << time << "\t" << time_t << std::endl;
+  }
+#else
+  std::cout << "zero is not available, the benchmark is skipped"
+            << std::endl;
+#endif  // ZERO
+  return EXIT_SUCCESS;
+}
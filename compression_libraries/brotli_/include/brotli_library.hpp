@@ -36,6 +36,19 @@ class BrotliLibrary : public CpuCompressionLibrary {
                   const uint64_t &compressed_data_size, char *decompressed_data,
                   uint64_t *decompressed_data_size);
 
+  bool CompressAgainst(const char *const reference_data,
+                       const uint64_t &reference_data_size,
+                       const char *const uncompressed_data,
+                       const uint64_t &uncompressed_data_size,
+                       char *compressed_data, uint64_t *compressed_data_size);
+
+  bool DecompressAgainst(const char *const reference_data,
+                         const uint64_t &reference_data_size,
+                         const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size);
+
   void GetTitle();
 
   bool GetCompressionLevelInformation(
@@ -17,6 +17,11 @@
 bool BrotliLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   if (compressor) {
+    // Text uses the UTF-8 mode when there is no other mode
+    if (!options->ModeIsSet() && options->DataTypeIsSet() &&
+        options->GetDataType() == kCpuText) {
+      options->SetMode(1);
+    }
     result =
         CpuCompressionLibrary::CheckCompressionLevel("brotli", options, 0, 11);
     if (result) {
@@ -75,6 +80,99 @@ bool BrotliLibrary::Decompress(const char *const compressed_data,
   return result;
 }
 
+bool BrotliLibrary::CompressAgainst(const char *const reference_data,
+                                    const uint64_t &reference_data_size,
+                                    const char *const uncompressed_data,
+                                    const uint64_t &uncompressed_data_size,
+                                    char *compressed_data,
+                                    uint64_t *compressed_data_size) {
+#ifdef SHARED_BROTLI_MAX_COMPOUND_DICTS
+  // Since brotli 1.1 the reference can be a raw dictionary
+  bool result{initialized_compressor_};
+  if (result) {
+    BrotliEncoderPreparedDictionary *dictionary =
+        BrotliEncoderPrepareDictionary(
+            BROTLI_SHARED_DICTIONARY_RAW, reference_data_size,
+            reinterpret_cast<const uint8_t *>(reference_data),
+            options_.GetCompressionLevel(), nullptr, nullptr, nullptr);
+    BrotliEncoderState *state =
+        BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+    result = dictionary && state;
+    if (result) {
+      BrotliEncoderSetParameter(state, BROTLI_PARAM_QUALITY,
+                                options_.GetCompressionLevel());
+      BrotliEncoderSetParameter(state, BROTLI_PARAM_LGWIN,
+                                options_.GetWindowSize());
+      BrotliEncoderSetParameter(state, BROTLI_PARAM_MODE, options_.GetMode());
+      BrotliEncoderSetParameter(state, BROTLI_PARAM_SIZE_HINT,
+                                uncompressed_data_size);
+      size_t available_in = uncompressed_data_size;
+      const uint8_t *next_in =
+          reinterpret_cast<const uint8_t *>(uncompressed_data);
+      size_t available_out = *compressed_data_size;
+      uint8_t *next_out = reinterpret_cast<uint8_t *>(compressed_data);
+      result = BrotliEncoderAttachPreparedDictionary(state, dictionary) &&
+               BrotliEncoderCompressStream(state, BROTLI_OPERATION_FINISH,
+                                           &available_in, &next_in,
+                                           &available_out, &next_out,
+                                           nullptr) &&
+               BrotliEncoderIsFinished(state);
+      *compressed_data_size -= available_out;
+    }
+    if (state) BrotliEncoderDestroyInstance(state);
+    if (dictionary) BrotliEncoderDestroyPreparedDictionary(dictionary);
+    if (!result) {
+      std::cout << "ERROR: brotli error when compress data" << std::endl;
+    }
+  }
+  return result;
+#else
+  return CpuCompressionLibrary::CompressAgainst(
+      reference_data, reference_data_size, uncompressed_data,
+      uncompressed_data_size, compressed_data, compressed_data_size);
+#endif  // SHARED_BROTLI_MAX_COMPOUND_DICTS
+}
+
+bool BrotliLibrary::DecompressAgainst(const char *const reference_data,
+                                      const uint64_t &reference_data_size,
+                                      const char *const compressed_data,
+                                      const uint64_t &compressed_data_size,
+                                      char *decompressed_data,
+                                      uint64_t *decompressed_data_size) {
+#ifdef SHARED_BROTLI_MAX_COMPOUND_DICTS
+  bool result{initialized_decompressor_};
+  if (result) {
+    BrotliDecoderState *state =
+        BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+    result = state;
+    if (result) {
+      size_t available_in = compressed_data_size;
+      const uint8_t *next_in =
+          reinterpret_cast<const uint8_t *>(compressed_data);
+      size_t available_out = *decompressed_data_size;
+      uint8_t *next_out = reinterpret_cast<uint8_t *>(decompressed_data);
+      result = BrotliDecoderAttachDictionary(
+                   state, BROTLI_SHARED_DICTIONARY_RAW, reference_data_size,
+                   reinterpret_cast<const uint8_t *>(reference_data)) &&
+               BROTLI_DECODER_RESULT_SUCCESS ==
+                   BrotliDecoderDecompressStream(state, &available_in,
+                                                 &next_in, &available_out,
+                                                 &next_out, nullptr);
+      *decompressed_data_size -= available_out;
+      BrotliDecoderDestroyInstance(state);
+    }
+    if (!result) {
+      std::cout << "ERROR: brotli error when decompress data" << std::endl;
+    }
+  }
+  return result;
+#else
+  return CpuCompressionLibrary::DecompressAgainst(
+      reference_data, reference_data_size, compressed_data,
+      compressed_data_size, decompressed_data, decompressed_data_size);
+#endif  // SHARED_BROTLI_MAX_COMPOUND_DICTS
+}
+
 void BrotliLibrary::GetTitle() {
   CpuCompressionLibrary::GetTitle(
       "brotli",
@@ -21,9 +21,27 @@ class Bzip2Library : public CpuCompressionLibrary {
   uint8_t number_of_modes_;
   std::string *modes_;
 
+  uint64_t GetStreamSize();
+
+  bool CompressStream(const char *const uncompressed_data,
+                      const uint64_t &uncompressed_data_size,
+                      char *compressed_data, uint64_t *compressed_data_size);
+
+  // With a buffer, the output is written there instead, and it grows up to
+  // the given decompressed size
+  bool DecompressStreams(const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size,
+                         std::vector<char> *buffer = nullptr);
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size);
+
   bool Compress(const char *const uncompressed_data,
                 const uint64_t &uncompressed_data_size, char *compressed_data,
                 uint64_t *compressed_data_size);
@@ -47,6 +65,10 @@ class Bzip2Library : public CpuCompressionLibrary {
       std::vector<std::string> *work_factor_information = nullptr,
       uint8_t *minimum_factor = nullptr, uint8_t *maximum_factor = nullptr);
 
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr);
+
   std::string GetModeName(const uint8_t &mode);
 
   Bzip2Library();
@@ -7,6 +7,8 @@
  */
 
 #include <bzlib.h>
+#include <limits.h>
+#include <string.h>
 
 // CPU-SMASH LIBRARIES
 #include <bzip2_library.hpp>
@@ -14,33 +16,185 @@
 
 bool Bzip2Library::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
-  if (compressor) {
+  result = CpuCompressionLibrary::CheckNumberThreads("bzip2", options, 1, 8);
+  if (compressor && result) {
     result =
         CpuCompressionLibrary::CheckCompressionLevel("bzip2", options, 1, 9);
     if (result) {
       result = CpuCompressionLibrary::CheckWorkFactor("bzip2", options, 0, 25);
     }
-  } else {
+  } else if (result) {
     result = CpuCompressionLibrary::CheckMode("bzip2", options, 0, 1);
   }
   return result;
 }
 
+static inline unsigned int GetChunk(const uint64_t &size) {
+  // bz_stream counters are 32 bits wide
+  return (size < UINT_MAX) ? static_cast<unsigned int>(size) : UINT_MAX;
+}
+
+static inline uint64_t GetBound(const uint64_t &size) {
+  return size + size / 100 + 600;
+}
+
+uint64_t Bzip2Library::GetStreamSize() {
+  // One bzip2 block per stream, as pbzip2 does
+  return options_.GetCompressionLevel() * 100000;
+}
+
+void Bzip2Library::GetCompressedDataSize(
+    const char *const uncompressed_data, const uint64_t &uncompressed_data_size,
+    uint64_t *compressed_data_size) {
+  uint64_t stream_size = GetStreamSize();
+  if (options_.GetNumberThreads() > 1 &&
+      uncompressed_data_size > stream_size) {
+    uint64_t number_of_streams =
+        (uncompressed_data_size + stream_size - 1) / stream_size;
+    *compressed_data_size = (number_of_streams - 1) * GetBound(stream_size) +
+                            GetBound(uncompressed_data_size -
+                                     (number_of_streams - 1) * stream_size);
+  } else {
+    *compressed_data_size = GetBound(uncompressed_data_size);
+  }
+}
+
+bool Bzip2Library::CompressStream(const char *const uncompressed_data,
+                                  const uint64_t &uncompressed_data_size,
+                                  char *compressed_data,
+                                  uint64_t *compressed_data_size) {
+  bz_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  bool result = (BZ2_bzCompressInit(&stream, options_.GetCompressionLevel(),
+                                    0 /* verbosity */,
+                                    options_.GetWorkFactor() * 10) == BZ_OK);
+  if (result) {
+    uint64_t consumed{0}, produced{0};
+    int bzerr{BZ_RUN_OK};
+    while (result && bzerr != BZ_STREAM_END) {
+      stream.next_in = const_cast<char *>(uncompressed_data + consumed);
+      stream.avail_in = GetChunk(uncompressed_data_size - consumed);
+      stream.next_out = compressed_data + produced;
+      stream.avail_out = GetChunk(*compressed_data_size - produced);
+      unsigned int available_in = stream.avail_in;
+      unsigned int available_out = stream.avail_out;
+      bzerr = BZ2_bzCompress(&stream,
+                             (uncompressed_data_size - consumed < UINT_MAX)
+                                 ? BZ_FINISH
+                                 : BZ_RUN);
+      consumed += available_in - stream.avail_in;
+      produced += available_out - stream.avail_out;
+      if ((bzerr != BZ_RUN_OK && bzerr != BZ_FINISH_OK &&
+           bzerr != BZ_STREAM_END) ||
+          (bzerr != BZ_STREAM_END && produced == *compressed_data_size)) {
+        result = false;
+      }
+    }
+    BZ2_bzCompressEnd(&stream);
+    *compressed_data_size = produced;
+  }
+  return result;
+}
+
+bool Bzip2Library::DecompressStreams(const char *const compressed_data,
+                                     const uint64_t &compressed_data_size,
+                                     char *decompressed_data,
+                                     uint64_t *decompressed_data_size,
+                                     std::vector<char> *buffer) {
+  bool result{true};
+  uint64_t consumed{0}, produced{0};
+  // Concatenated streams are decoded one after the other, and the output
+  // grows on demand when it is an internal buffer. It does not grow beyond
+  // the size of the output, so bad data fails as the output is full
+  while (result && consumed < compressed_data_size) {
+    bz_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    result = (BZ2_bzDecompressInit(&stream, 0 /* verbosity */,
+                                   options_.GetMode()) == BZ_OK);
+    int bzerr{BZ_OK};
+    while (result && bzerr != BZ_STREAM_END) {
+      if (buffer && produced == buffer->size() &&
+          buffer->size() < *decompressed_data_size) {
+        uint64_t size = (buffer->size()) ? buffer->size() * 2 : 1 << 20;
+        buffer->resize((size < *decompressed_data_size)
+                           ? size
+                           : *decompressed_data_size);
+      }
+      char *output = (buffer) ? buffer->data() : decompressed_data;
+      uint64_t output_size = (buffer) ? buffer->size() : *decompressed_data_size;
+      stream.next_in = const_cast<char *>(compressed_data + consumed);
+      stream.avail_in = GetChunk(compressed_data_size - consumed);
+      stream.next_out = output + produced;
+      stream.avail_out = GetChunk(output_size - produced);
+      unsigned int available_in = stream.avail_in;
+      unsigned int available_out = stream.avail_out;
+      bzerr = BZ2_bzDecompress(&stream);
+      consumed += available_in - stream.avail_in;
+      produced += available_out - stream.avail_out;
+      if ((bzerr != BZ_OK && bzerr != BZ_STREAM_END) ||
+          (bzerr == BZ_OK && available_in == stream.avail_in &&
+           available_out == stream.avail_out)) {
+        // Corrupted or truncated data, or the output is full
+        result = false;
+      }
+    }
+    BZ2_bzDecompressEnd(&stream);
+  }
+  *decompressed_data_size = produced;
+  return result;
+}
+
 bool Bzip2Library::Compress(const char *const uncompressed_data,
                             const uint64_t &uncompressed_data_size,
                             char *compressed_data,
                             uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    int bzerr = BZ2_bzBuffToBuffCompress(
-        compressed_data, reinterpret_cast<uint32_t *>(compressed_data_size),
-        const_cast<char *const>(uncompressed_data),
-        static_cast<uint32_t>(uncompressed_data_size),
-        options_.GetCompressionLevel(), 0 /* verbosity */,
-        options_.GetWorkFactor() * 10);
-    if (bzerr != BZ_OK && bzerr != BZ_OUTBUFF_FULL) {
+    uint64_t stream_size = GetStreamSize();
+    uint64_t number_of_streams =
+        (uncompressed_data_size + stream_size - 1) / stream_size;
+    if (options_.GetNumberThreads() == 1 || number_of_streams <= 1) {
+      result = CompressStream(uncompressed_data, uncompressed_data_size,
+                              compressed_data, compressed_data_size);
+    } else {
+      uint64_t required_size{0};
+      GetCompressedDataSize(uncompressed_data, uncompressed_data_size,
+                            &required_size);
+      if (result = (required_size <= *compressed_data_size)) {
+        // Every stream is compressed into its own slice of the output and
+        // then moved next to the previous one, which gives a standard
+        // multi-stream file
+        uint64_t slice_size = GetBound(stream_size);
+        std::vector<uint64_t> streams_size(number_of_streams);
+        std::vector<char> streams_result(number_of_streams);
+        ParallelFor(number_of_streams, options_.GetNumberThreads(),
+                    [&](const uint64_t &stream) {
+                      uint64_t offset = stream * stream_size;
+                      uint64_t size =
+                          (stream_size < uncompressed_data_size - offset)
+                              ? stream_size
+                              : uncompressed_data_size - offset;
+                      streams_size[stream] = GetBound(size);
+                      streams_result[stream] = CompressStream(
+                          uncompressed_data + offset, size,
+                          compressed_data + stream * slice_size,
+                          &streams_size[stream]);
+                    });
+        uint64_t compressed_bytes{0};
+        for (uint64_t stream = 0; result && stream < number_of_streams;
+             ++stream) {
+          if (result = streams_result[stream]) {
+            memmove(compressed_data + compressed_bytes,
+                    compressed_data + stream * slice_size,
+                    streams_size[stream]);
+            compressed_bytes += streams_size[stream];
+          }
+        }
+        *compressed_data_size = compressed_bytes;
+      }
+    }
+    if (!result) {
       std::cout << "ERROR: bzip2 error when compress data" << std::endl;
-      result = false;
     }
   }
   return result;
@@ -52,14 +206,65 @@ bool Bzip2Library::Decompress(const char *const compressed_data,
                               uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
   if (result) {
-    int bzerr = BZ2_bzBuffToBuffDecompress(
-        decompressed_data, reinterpret_cast<uint32_t *>(decompressed_data_size),
-        const_cast<char *const>(compressed_data),
-        static_cast<uint32_t>(compressed_data_size), options_.GetMode(),
-        0 /* verbosity */);
-    if (bzerr != BZ_OK) {
+    // Streams start at byte boundaries with the "BZh" signature, the block
+    // size and the magic number of the first block
+    std::vector<uint64_t> streams_offset{0};
+    if (options_.GetNumberThreads() > 1) {
+      static const char kBlockMagic[] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+      const char *position = compressed_data + 1;
+      const char *end = compressed_data + compressed_data_size;
+      while (end - position >= 10 &&
+             (position = reinterpret_cast<const char *>(
+                  memchr(position, 'B', end - position - 9)))) {
+        if (position[1] == 'Z' && position[2] == 'h' && position[3] >= '1' &&
+            position[3] <= '9' &&
+            memcmp(position + 4, kBlockMagic, sizeof(kBlockMagic)) == 0) {
+          streams_offset.push_back(position - compressed_data);
+        }
+        ++position;
+      }
+    }
+    if (streams_offset.size() == 1) {
+      result = DecompressStreams(compressed_data, compressed_data_size,
+                                 decompressed_data, decompressed_data_size);
+    } else {
+      uint64_t number_of_streams = streams_offset.size();
+      streams_offset.push_back(compressed_data_size);
+      std::vector<std::vector<char>> buffers(number_of_streams);
+      // No stream can be larger than the whole output
+      std::vector<uint64_t> streams_size(number_of_streams,
+                                         *decompressed_data_size);
+      std::vector<char> streams_result(number_of_streams);
+      ParallelFor(number_of_streams, options_.GetNumberThreads(),
+                  [&](const uint64_t &stream) {
+                    streams_result[stream] = DecompressStreams(
+                        compressed_data + streams_offset[stream],
+                        streams_offset[stream + 1] - streams_offset[stream],
+                        nullptr, &streams_size[stream], &buffers[stream]);
+                  });
+      uint64_t decompressed_bytes{0};
+      for (uint64_t stream = 0; result && stream < number_of_streams;
+           ++stream) {
+        result = streams_result[stream] &&
+                 (decompressed_bytes + streams_size[stream] <=
+                  *decompressed_data_size);
+        if (result) {
+          memcpy(decompressed_data + decompressed_bytes,
+                 buffers[stream].data(), streams_size[stream]);
+          decompressed_bytes += streams_size[stream];
+        }
+      }
+      if (result) {
+        *decompressed_data_size = decompressed_bytes;
+      } else {
+        // A signature found inside compressed data splits a stream, so the
+        // whole input is decoded sequentially instead
+        result = DecompressStreams(compressed_data, compressed_data_size,
+                                   decompressed_data, decompressed_data_size);
+      }
+    }
+    if (!result) {
       std::cout << "ERROR: bzip2 error when decompress data" << std::endl;
-      result = false;
     }
   }
   return result;
@@ -115,6 +320,19 @@ bool Bzip2Library::GetWorkFactorInformation(
   return true;
 }
 
+bool Bzip2Library::GetNumberThreadsInformation(
+    std::vector<std::string> *number_threads_information,
+    uint8_t *minimum_threads, uint8_t *maximum_threads) {
+  if (minimum_threads) *minimum_threads = 1;
+  if (maximum_threads) *maximum_threads = 8;
+  if (number_threads_information) {
+    number_threads_information->clear();
+    number_threads_information->push_back("Available values [1-8]");
+    number_threads_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
 std::string Bzip2Library::GetModeName(const uint8_t &mode) {
   std::string result = "ERROR";
   if (mode < number_of_modes_) {
@@ -20,6 +20,7 @@ class CBlosc2Library : public CpuCompressionLibrary {
  private:
   uint8_t number_of_flags_;
   std::string *flags_;
+  uint32_t number_threads_;
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
@@ -60,6 +61,8 @@ class CBlosc2Library : public CpuCompressionLibrary {
 
   std::string GetFlagsName(const uint8_t &flags);
 
+  void Reset();
+
   CBlosc2Library();
   ~CBlosc2Library();
 };
@@ -11,11 +11,16 @@
 // CPU-SMASH LIBRARIES
 #include <c-blosc2_library.hpp>
 #include <cpu_options.hpp>
+#include <cpu_thread_budget.hpp>
 
 bool CBlosc2Library::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   result = CpuCompressionLibrary::CheckNumberThreads("c-blosc2", options, 1, 8);
   if (compressor && result) {
+    // Typed data is shuffled when there is no other flag
+    if (!options->FlagsIsSet() && options->GetDataTypeSize() > 1) {
+      options->SetFlags(1);
+    }
     result = CpuCompressionLibrary::CheckFlags("c-blosc2", options, 0, 2);
     if (result) {
       result = CpuCompressionLibrary::CheckCompressionLevel("c-blosc2", options,
@@ -28,6 +33,7 @@ bool CBlosc2Library::CheckOptions(CpuOptions *options, const bool &compressor) {
 bool CBlosc2Library::SetOptionsCompressor(CpuOptions *options) {
   if (initialized_compressor_ || initialized_decompressor_) {
     blosc_destroy();
+    CpuThreadBudget::ReleaseThreads(number_threads_);
     initialized_decompressor_ = false;
   }
   initialized_compressor_ = CheckOptions(options, true);
@@ -35,7 +41,10 @@ bool CBlosc2Library::SetOptionsCompressor(CpuOptions *options) {
     options_ = *options;
     blosc_init();
     blosc_set_compressor("blosclz");
-    blosc_set_nthreads(options_.GetNumberThreads());
+    // Blosc threads live until blosc_destroy, so they are borrowed until then
+    number_threads_ =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
+    blosc_set_nthreads(number_threads_);
   }
   return initialized_compressor_;
 }
@@ -43,13 +52,16 @@ bool CBlosc2Library::SetOptionsCompressor(CpuOptions *options) {
 bool CBlosc2Library::SetOptionsDecompressor(CpuOptions *options) {
   if (initialized_compressor_ || initialized_decompressor_) {
     blosc_destroy();
+    CpuThreadBudget::ReleaseThreads(number_threads_);
     initialized_compressor_ = false;
   }
   initialized_decompressor_ = CheckOptions(options, false);
   if (initialized_decompressor_) {
     options_ = *options;
     blosc_init();
-    blosc_set_nthreads(options_.GetNumberThreads());
+    number_threads_ =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
+    blosc_set_nthreads(number_threads_);
   }
   return initialized_decompressor_;
 }
@@ -66,9 +78,18 @@ bool CBlosc2Library::Compress(const char *const uncompressed_data,
                               uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
+    // The shuffle of blosc uses the size of the elements, unless the data
+    // has been already filtered by CPU-Smash
+    size_t type_size{sizeof(char)};
+    if (options_.ElementSizeIsSet() &&
+        (!options_.FilterIsSet() || options_.GetFilter() == 0)) {
+      type_size = options_.GetElementSize();
+    } else if (!options_.ElementSizeIsSet() && options_.DataTypeIsSet()) {
+      type_size = options_.GetDataTypeSize();
+    }
     int csize =
         blosc_compress(options_.GetCompressionLevel(), options_.GetFlags(),
-                       sizeof(char), uncompressed_data_size, uncompressed_data,
+                       type_size, uncompressed_data_size, uncompressed_data,
                        compressed_data, *compressed_data_size);
     if (csize == 0 || csize < 0) {
       std::cout << "ERROR: c-blosc2 error when compress data" << std::endl;
@@ -160,6 +181,7 @@ std::string CBlosc2Library::GetFlagsName(const uint8_t &flags) {
 }
 
 CBlosc2Library::CBlosc2Library() {
+  number_threads_ = 1;
   number_of_flags_ = 3;
   flags_ = new std::string[number_of_flags_];
   flags_[0] = "None";
@@ -167,7 +189,19 @@ CBlosc2Library::CBlosc2Library() {
   flags_[2] = "Bit";
 }
 
+// Blosc is initialized with the options, and its threads are borrowed
+void CBlosc2Library::Reset() {
+  if (initialized_compressor_ || initialized_decompressor_) {
+    blosc_destroy();
+    CpuThreadBudget::ReleaseThreads(number_threads_);
+  }
+  CpuCompressionLibrary::Reset();
+}
+
 CBlosc2Library::~CBlosc2Library() {
-  if (initialized_compressor_ || initialized_decompressor_) blosc_destroy();
+  if (initialized_compressor_ || initialized_decompressor_) {
+    blosc_destroy();
+    CpuThreadBudget::ReleaseThreads(number_threads_);
+  }
   delete[] flags_;
 }
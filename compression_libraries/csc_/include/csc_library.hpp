@@ -21,8 +21,8 @@
 class CscReader : ISeqInStream {
  private:
   const char *buffer_;
-  uint64_t buffer_size_;
-  uint64_t total_read_;
+  const char *const buffer_begin_;
+  const char *const buffer_end_;
 
  public:
   static SRes RealRead(void *istream, void *const buf, size_t *size);
@@ -34,8 +34,8 @@ class CscReader : ISeqInStream {
 class CscWriter : ISeqOutStream {
  private:
   char *buffer_;
-  uint64_t buffer_size_;
-  uint64_t total_write_;
+  char *const buffer_begin_;
+  char *const buffer_end_;
 
  public:
   static size_t RealWrite(void *ostream, const void *buf, size_t size);
@@ -22,21 +22,21 @@ SRes CscReader::RealRead(void *istream, void *const buf, size_t *size) {
 }
 
 size_t CscReader::GetData(void *const buf, const size_t &len) {
-  uint64_t real_size{0};
-  if (buf && len && buffer_ && buffer_size_) {
-    real_size = (len > buffer_size_) ? buffer_size_ : len;
+  uint64_t real_size = buffer_end_ - buffer_;
+  if (len < real_size) real_size = len;
+  if (real_size) {
     memcpy(buf, buffer_, real_size);
     buffer_ += real_size;
-    buffer_size_ -= real_size;
-    total_read_ += real_size;
   }
   return real_size;
 }
 
-size_t CscReader::GetInputSize() { return total_read_; }
+size_t CscReader::GetInputSize() { return buffer_ - buffer_begin_; }
 
 CscReader::CscReader(const char *buffer, const uint64_t &buffer_size)
-    : buffer_(buffer), buffer_size_(buffer_size), total_read_(0) {
+    : buffer_(buffer),
+      buffer_begin_(buffer),
+      buffer_end_(buffer ? buffer + buffer_size : buffer) {
   Read = CscReader::RealRead;
 }
 
@@ -46,21 +46,21 @@ size_t CscWriter::RealWrite(void *ostream, const void *buf, size_t size) {
 }
 
 size_t CscWriter::PutData(const void *buf, const size_t &len) {
-  uint64_t real_size{0};
-  if (buf && len && buffer_ && buffer_size_) {
-    real_size = (len > buffer_size_) ? buffer_size_ : len;
+  uint64_t real_size = buffer_end_ - buffer_;
+  if (len < real_size) real_size = len;
+  if (real_size) {
     memcpy(buffer_, buf, real_size);
     buffer_ += real_size;
-    buffer_size_ -= real_size;
-    total_write_ += real_size;
   }
   return real_size;
 }
 
-size_t CscWriter::GetOutputSize() { return total_write_; }
+size_t CscWriter::GetOutputSize() { return buffer_ - buffer_begin_; }
 
 CscWriter::CscWriter(char *buffer, uint64_t buffer_size)
-    : buffer_(buffer), buffer_size_(buffer_size), total_write_(0) {
+    : buffer_(buffer),
+      buffer_begin_(buffer),
+      buffer_end_(buffer ? buffer + buffer_size : buffer) {
   Write = CscWriter::RealWrite;
 }
 
@@ -83,6 +83,12 @@ bool CscLibrary::Compress(const char *const uncompressed_data,
                           char *compressed_data,
                           uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
+  if (result && *compressed_data_size < CSC_PROP_SIZE) {
+    // There is no room for the properties
+    std::cout << "ERROR: csc error when compress data" << std::endl;
+    *compressed_data_size = 0;
+    result = false;
+  }
   if (result) {
     CSCProps props;
 
@@ -96,7 +102,8 @@ bool CscLibrary::Compress(const char *const uncompressed_data,
     CSCEnc_WriteProperties(&props, reinterpret_cast<uint8_t *>(compressed_data),
                            0);
     CscReader reader(uncompressed_data, uncompressed_data_size);
-    CscWriter writer(compressed_data + CSC_PROP_SIZE, *compressed_data_size);
+    CscWriter writer(compressed_data + CSC_PROP_SIZE,
+                     *compressed_data_size - CSC_PROP_SIZE);
     CSCEncHandle handle = CSCEnc_Create(
         &props, reinterpret_cast<ISeqOutStream *>(&writer), nullptr);
     if (result = handle) {
@@ -121,6 +128,11 @@ bool CscLibrary::Decompress(const char *const compressed_data,
                             char *decompressed_data,
                             uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
+  if (result && compressed_data_size < CSC_PROP_SIZE) {
+    std::cout << "ERROR: csc error when decompress data" << std::endl;
+    *decompressed_data_size = 0;
+    result = false;
+  }
   if (result) {
     CSCProps props;
     CscReader reader(compressed_data, compressed_data_size);
@@ -10,6 +10,7 @@
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
+#include <cpu_thread_budget.hpp>
 #include <flzma2_library.hpp>
 
 bool Flzma2Library::CheckOptions(CpuOptions *options, const bool &compressor) {
@@ -37,10 +38,13 @@ bool Flzma2Library::Compress(const char *const uncompressed_data,
                              uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
+    uint32_t number_threads =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
     uint64_t compressed_bytes = FL2_compressMt(
         compressed_data, *compressed_data_size, uncompressed_data,
         uncompressed_data_size, options_.GetCompressionLevel(),
-        options_.GetNumberThreads());
+        number_threads);
+    CpuThreadBudget::ReleaseThreads(number_threads);
     if (compressed_bytes == 0 || compressed_bytes > *compressed_data_size) {
       std::cout << "ERROR: flzma2 error when compress data" << std::endl;
       result = false;
@@ -64,9 +68,12 @@ bool Flzma2Library::Decompress(const char *const compressed_data,
                                uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
   if (result) {
-    uint64_t decompressed_bytes = FL2_decompressMt(
-        decompressed_data, *decompressed_data_size, compressed_data,
-        compressed_data_size, options_.GetNumberThreads());
+    uint32_t number_threads =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
+    uint64_t decompressed_bytes =
+        FL2_decompressMt(decompressed_data, *decompressed_data_size,
+                         compressed_data, compressed_data_size, number_threads);
+    CpuThreadBudget::ReleaseThreads(number_threads);
     if (decompressed_bytes == 0 ||
         decompressed_bytes > *decompressed_data_size) {
       std::cout << "ERROR: flzma2 error when decompress data" << std::endl;
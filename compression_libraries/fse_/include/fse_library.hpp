@@ -21,6 +21,11 @@ class FseLibrary : public CpuCompressionLibrary {
   uint8_t number_of_modes_;
   std::string *modes_;
 
+  uint32_t CompressHuff0Block(const char *const uncompressed_data,
+                              const uint32_t &uncompressed_data_size,
+                              char *compressed_data,
+                              const uint64_t &compressed_data_size);
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
@@ -43,6 +48,10 @@ class FseLibrary : public CpuCompressionLibrary {
                           uint8_t *maximum_mode = nullptr,
                           const uint8_t &compression_level = 0);
 
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr);
+
   std::string GetModeName(const uint8_t &mode);
 
   FseLibrary();
@@ -17,9 +17,30 @@
 bool FseLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   result = CpuCompressionLibrary::CheckMode("fse", options, 0, 1);
+  if (result) {
+    result = CpuCompressionLibrary::CheckNumberThreads("fse", options, 1, 8);
+  }
   return result;
 }
 
+uint32_t FseLibrary::CompressHuff0Block(const char *const uncompressed_data,
+                                        const uint32_t &uncompressed_data_size,
+                                        char *compressed_data,
+                                        const uint64_t &compressed_data_size) {
+  uint32_t compressed_bytes = HUF_original_compress(
+      compressed_data + sizeof(compressed_bytes),
+      compressed_data_size - sizeof(compressed_bytes), uncompressed_data,
+      uncompressed_data_size);
+  if (!compressed_bytes) {
+    // Raw data
+    memcpy(compressed_data + sizeof(compressed_bytes), uncompressed_data,
+           uncompressed_data_size);
+    compressed_bytes = uncompressed_data_size;
+  }
+  memcpy(compressed_data, &compressed_bytes, sizeof(compressed_bytes));
+  return compressed_bytes + sizeof(compressed_bytes);
+}
+
 void FseLibrary::GetCompressedDataSize(const char *const uncompressed_data,
                                        const uint64_t &uncompressed_data_size,
                                        uint64_t *compressed_data_size) {
@@ -62,34 +83,50 @@ bool FseLibrary::Compress(const char *const uncompressed_data,
                                   uncompressed_data, uncompressed_data_size);
         break;
       case 1: {
-        uint64_t current_uncompressed_data_size{uncompressed_data_size};
-        char *current_uncompressed_data = const_cast<char *>(uncompressed_data);
-        for (uint32_t current_bytes_to_compress = 0,
-                      current_compressed_bytes = 0;
-             current_uncompressed_data_size;) {
-          current_bytes_to_compress =
-              (current_uncompressed_data_size < HUF_original_BLOCKSIZE_MAX)
-                  ? current_uncompressed_data_size
-                  : HUF_original_BLOCKSIZE_MAX;
-          current_compressed_bytes = HUF_original_compress(
-              compressed_data + compressed_bytes +
-                  sizeof(current_compressed_bytes),
-              *compressed_data_size -
-                  (compressed_bytes + sizeof(current_compressed_bytes)),
-              current_uncompressed_data, current_bytes_to_compress);
-          if (!current_compressed_bytes) {
-            // Raw data
-            memcpy(compressed_data + compressed_bytes +
-                       sizeof(current_compressed_bytes),
-                   current_uncompressed_data, current_bytes_to_compress);
-            current_compressed_bytes = current_bytes_to_compress;
+        uint64_t number_of_blocks =
+            (uncompressed_data_size + HUF_original_BLOCKSIZE_MAX - 1) /
+            HUF_original_BLOCKSIZE_MAX;
+        auto get_block_size = [&](const uint64_t &block) -> uint32_t {
+          uint64_t remaining =
+              uncompressed_data_size - block * HUF_original_BLOCKSIZE_MAX;
+          return (remaining < HUF_original_BLOCKSIZE_MAX)
+                     ? remaining
+                     : HUF_original_BLOCKSIZE_MAX;
+        };
+        uint64_t required_size{0};
+        GetCompressedDataSize(uncompressed_data, uncompressed_data_size,
+                              &required_size);
+        if (options_.GetNumberThreads() == 1 || number_of_blocks <= 1 ||
+            required_size > *compressed_data_size) {
+          for (uint64_t block = 0; block < number_of_blocks; ++block) {
+            compressed_bytes += CompressHuff0Block(
+                uncompressed_data + block * HUF_original_BLOCKSIZE_MAX,
+                get_block_size(block), compressed_data + compressed_bytes,
+                *compressed_data_size - compressed_bytes);
+          }
+        } else {
+          // Every block is compressed into its own slice of the output and
+          // then moved next to the previous one, so the result is the same
+          // as the sequential one
+          uint64_t slice_size =
+              HUF_original_compressBound(HUF_original_BLOCKSIZE_MAX) +
+              sizeof(uint32_t);
+          std::vector<uint64_t> blocks_size(number_of_blocks);
+          ParallelFor(number_of_blocks, options_.GetNumberThreads(),
+                      [&](const uint64_t &block) {
+                        uint32_t bytes = get_block_size(block);
+                        blocks_size[block] = CompressHuff0Block(
+                            uncompressed_data +
+                                block * HUF_original_BLOCKSIZE_MAX,
+                            bytes, compressed_data + block * slice_size,
+                            HUF_original_compressBound(bytes) +
+                                sizeof(uint32_t));
+                      });
+          for (uint64_t block = 0; block < number_of_blocks; ++block) {
+            memmove(compressed_data + compressed_bytes,
+                    compressed_data + block * slice_size, blocks_size[block]);
+            compressed_bytes += blocks_size[block];
           }
-          *reinterpret_cast<uint32_t *>(compressed_data + compressed_bytes) =
-              current_compressed_bytes;
-          compressed_bytes +=
-              current_compressed_bytes + sizeof(current_compressed_bytes);
-          current_uncompressed_data += current_bytes_to_compress;
-          current_uncompressed_data_size -= current_bytes_to_compress;
         }
         break;
       }
@@ -120,25 +157,47 @@ bool FseLibrary::Decompress(const char *const compressed_data,
                                     compressed_data, compressed_data_size);
         break;
       case 1: {
-        uint64_t current_compressed_data_size{compressed_data_size};
-        char *current_compressed_data = const_cast<char *>(compressed_data);
-        for (uint32_t current_bytes_to_decompress = 0,
-                      current_decompressed_bytes = 0;
-             current_compressed_data_size;) {
-          current_bytes_to_decompress =
-              *reinterpret_cast<uint32_t *>(current_compressed_data);
-          current_compressed_data += sizeof(current_bytes_to_decompress);
-          current_compressed_data_size -= sizeof(current_bytes_to_decompress);
-          current_decompressed_bytes =
-              (current_bytes_to_decompress == current_compressed_data_size)
-                  ? (*decompressed_data_size) - decompressed_bytes
-                  : HUF_original_BLOCKSIZE_MAX;
-          decompressed_bytes += HUF_original_decompress(
-              decompressed_data + decompressed_bytes,
-              current_decompressed_bytes, current_compressed_data,
-              current_bytes_to_decompress);
-          current_compressed_data += current_bytes_to_decompress;
-          current_compressed_data_size -= current_bytes_to_decompress;
+        // The blocks are located first, so they can be decoded concurrently
+        std::vector<uint64_t> blocks_offset;
+        for (uint64_t offset = 0;
+             offset + sizeof(uint32_t) <= compressed_data_size;) {
+          blocks_offset.push_back(offset);
+          uint32_t block_size;
+          memcpy(&block_size, compressed_data + offset, sizeof(block_size));
+          offset += block_size + sizeof(uint32_t);
+        }
+        uint64_t number_of_blocks = blocks_offset.size();
+        std::vector<uint64_t> blocks_size(number_of_blocks, 0);
+        ParallelFor(
+            number_of_blocks, options_.GetNumberThreads(),
+            [&](const uint64_t &block) {
+              const char *block_data = compressed_data + blocks_offset[block];
+              uint32_t bytes_to_decompress;
+              memcpy(&bytes_to_decompress, block_data,
+                     sizeof(bytes_to_decompress));
+              uint64_t offset = block * HUF_original_BLOCKSIZE_MAX;
+              // The last block takes the rest of the output buffer
+              uint64_t bytes = (block == number_of_blocks - 1)
+                                   ? *decompressed_data_size - offset
+                                   : HUF_original_BLOCKSIZE_MAX;
+              if (offset + bytes <= *decompressed_data_size &&
+                  blocks_offset[block] + sizeof(uint32_t) +
+                          bytes_to_decompress <=
+                      compressed_data_size) {
+                uint64_t decompressed_block_bytes = HUF_original_decompress(
+                    decompressed_data + offset, bytes,
+                    block_data + sizeof(uint32_t), bytes_to_decompress);
+                if (decompressed_block_bytes <= bytes) {
+                  blocks_size[block] = decompressed_block_bytes;
+                }
+              }
+            });
+        for (uint64_t block = 0; block < number_of_blocks; ++block) {
+          if (!blocks_size[block]) {
+            decompressed_bytes = 0;
+            break;
+          }
+          decompressed_bytes += blocks_size[block];
         }
         break;
       }
@@ -177,6 +236,20 @@ bool FseLibrary::GetModeInformation(std::vector<std::string> *mode_information,
   return true;
 }
 
+bool FseLibrary::GetNumberThreadsInformation(
+    std::vector<std::string> *number_threads_information,
+    uint8_t *minimum_threads, uint8_t *maximum_threads) {
+  if (minimum_threads) *minimum_threads = 1;
+  if (maximum_threads) *maximum_threads = 8;
+  if (number_threads_information) {
+    number_threads_information->clear();
+    number_threads_information->push_back("Available values [1-8]");
+    number_threads_information->push_back("Only used by Huff0 coder");
+    number_threads_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
 std::string FseLibrary::GetModeName(const uint8_t &mode) {
   std::string result = "ERROR";
   if (mode < number_of_modes_) {
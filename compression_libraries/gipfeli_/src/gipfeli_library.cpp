@@ -56,9 +56,10 @@ bool GipfeliLibrary::Compress(const char *const uncompressed_data,
                               uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    uint64_t real_compressed_size = compressor_->RawCompress(
-        std::string(uncompressed_data, uncompressed_data_size),
-        compressed_data);
+    util::compression::ByteArraySource source(uncompressed_data,
+                                              uncompressed_data_size);
+    util::compression::UncheckedByteArraySink sink(compressed_data);
+    uint64_t real_compressed_size = compressor_->CompressStream(&source, &sink);
     if (real_compressed_size > *compressed_data_size) {
       std::cout << "ERROR: gipfeli error when compress data" << std::endl;
       result = false;
@@ -8,6 +8,11 @@
 
 #pragma once
 
+extern "C" {
+#include <heatshrink_decoder.h>
+#include <heatshrink_encoder.h>
+}
+
 #include <iostream>
 #include <string>
 #include <vector>
@@ -17,9 +22,20 @@
 #include <cpu_options.hpp>
 
 class HeatshrinkLibrary : public CpuCompressionLibrary {
+ private:
+  // Sessions are reset between messages instead of allocated again
+  heatshrink_encoder *encoder_;
+  heatshrink_decoder *decoder_;
+
+  void FreeSessions();
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
   bool Compress(const char *const uncompressed_data,
                 const uint64_t &uncompressed_data_size, char *compressed_data,
                 uint64_t *compressed_data_size);
@@ -28,6 +44,13 @@ class HeatshrinkLibrary : public CpuCompressionLibrary {
                   const uint64_t &compressed_data_size, char *decompressed_data,
                   uint64_t *decompressed_data_size);
 
+  bool Sink(const char *const data, const uint64_t &data_size,
+            uint64_t *sunk_data_size);
+
+  bool Poll(char *data, uint64_t *data_size, bool *more_data);
+
+  bool Finish(bool *finished);
+
   void GetTitle();
 
   bool GetWindowSizeInformation(
@@ -39,6 +62,8 @@ class HeatshrinkLibrary : public CpuCompressionLibrary {
       uint8_t *minimum_back_reference = nullptr,
       uint8_t *maximum_back_reference = nullptr);
 
+  bool IsStateless();
+
   HeatshrinkLibrary();
   ~HeatshrinkLibrary();
 };
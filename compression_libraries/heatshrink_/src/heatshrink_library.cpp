@@ -26,57 +26,80 @@ bool HeatshrinkLibrary::CheckOptions(CpuOptions *options,
   return result;
 }
 
+bool HeatshrinkLibrary::SetOptionsCompressor(CpuOptions *options) {
+  FreeSessions();
+  if (CpuCompressionLibrary::SetOptionsCompressor(options)) {
+    encoder_ = heatshrink_encoder_alloc(options_.GetWindowSize(),
+                                        options_.GetBackReference());
+    if (!(initialized_compressor_ = encoder_)) {
+      std::cout << "ERROR: heatshrink error when create compressor"
+                << std::endl;
+    }
+  }
+  return initialized_compressor_;
+}
+
+bool HeatshrinkLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  FreeSessions();
+  if (CpuCompressionLibrary::SetOptionsDecompressor(options)) {
+    decoder_ = heatshrink_decoder_alloc(256, options_.GetWindowSize(),
+                                        options_.GetBackReference());
+    if (!(initialized_decompressor_ = decoder_)) {
+      std::cout << "ERROR: heatshrink error when create decompressor"
+                << std::endl;
+    }
+  }
+  return initialized_decompressor_;
+}
+
 bool HeatshrinkLibrary::Compress(const char *const uncompressed_data,
                                  const uint64_t &uncompressed_data_size,
                                  char *compressed_data,
                                  uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    heatshrink_encoder *compression = heatshrink_encoder_alloc(
-        options_.GetWindowSize(), options_.GetBackReference());
-    if (result = compression) {
-      uint64_t size{0};
-      uint64_t bytes{0};
-      HSE_sink_res sres;
-      HSE_poll_res pres;
-      HSE_finish_res fres;
-      uint64_t current_uncompressed_data_size{uncompressed_data_size};
-      uint8_t *current_uncompressed_data = const_cast<uint8_t *>(
-          reinterpret_cast<const uint8_t *const>(uncompressed_data));
-      while (current_uncompressed_data_size && result) {
-        sres = heatshrink_encoder_sink(
-            compression, reinterpret_cast<uint8_t *>(current_uncompressed_data),
-            current_uncompressed_data_size, &size);
-        result = (sres >= 0) && (size <= current_uncompressed_data_size);
+    // Drops any unfinished incremental message
+    heatshrink_encoder_reset(encoder_);
+    size_t size{0};
+    uint64_t bytes{0};
+    HSE_sink_res sres;
+    HSE_poll_res pres;
+    HSE_finish_res fres;
+    uint64_t current_uncompressed_data_size{uncompressed_data_size};
+    uint8_t *current_uncompressed_data = const_cast<uint8_t *>(
+        reinterpret_cast<const uint8_t *const>(uncompressed_data));
+    while (current_uncompressed_data_size && result) {
+      sres = heatshrink_encoder_sink(encoder_, current_uncompressed_data,
+                                     current_uncompressed_data_size, &size);
+      result = (sres >= 0) && (size <= current_uncompressed_data_size);
+      if (result && size) {
+        current_uncompressed_data += size;
+        current_uncompressed_data_size -= size;
+      }
+      if (!current_uncompressed_data_size && result) {
+        fres = heatshrink_encoder_finish(encoder_);
+        result = (fres == HSER_FINISH_MORE);
+      }
+      for (pres = HSER_POLL_MORE; pres == HSER_POLL_MORE && result;) {
+        pres = heatshrink_encoder_poll(
+            encoder_, reinterpret_cast<uint8_t *>(compressed_data),
+            *compressed_data_size - bytes, &size);
+        result = (pres >= 0) && (bytes + size <= *compressed_data_size);
         if (result && size) {
-          current_uncompressed_data += size;
-          current_uncompressed_data_size -= size;
-        }
-        if (!current_uncompressed_data_size && result) {
-          fres = heatshrink_encoder_finish(compression);
-          result = (fres == HSER_FINISH_MORE);
-        }
-        for (pres = HSER_POLL_MORE; pres == HSER_POLL_MORE && result;) {
-          pres = heatshrink_encoder_poll(
-              compression, reinterpret_cast<uint8_t *>(compressed_data),
-              *compressed_data_size, &size);
-          result = (pres >= 0) && (bytes + size <= *compressed_data_size);
-          if (result && size) {
-            bytes += size;
-            compressed_data += size;
-          }
+          bytes += size;
+          compressed_data += size;
         }
       }
-      if (result) {
-        fres = heatshrink_encoder_finish(compression);
-        if (fres < 0 || fres != HSER_FINISH_DONE ||
-            bytes > *compressed_data_size) {
-          result = false;
-        }
+    }
+    if (result) {
+      fres = heatshrink_encoder_finish(encoder_);
+      if (fres < 0 || fres != HSER_FINISH_DONE ||
+          bytes > *compressed_data_size) {
+        result = false;
       }
-      *compressed_data_size = bytes;
-      heatshrink_encoder_free(compression);
     }
+    *compressed_data_size = bytes;
+    heatshrink_encoder_reset(encoder_);
     if (!result) {
       std::cout << "ERROR: heatshrink error when compress data" << std::endl;
     }
@@ -90,51 +113,47 @@ bool HeatshrinkLibrary::Decompress(const char *const compressed_data,
                                    uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
   if (result) {
-    heatshrink_decoder *decompression = heatshrink_decoder_alloc(
-        256, options_.GetWindowSize(), options_.GetBackReference());
-    if (result = decompression) {
-      uint64_t size{0};
-      uint64_t bytes = 0;
-      HSD_sink_res sres;
-      HSD_poll_res pres;
-      HSD_finish_res fres;
-      uint64_t current_compressed_data_size{compressed_data_size};
-      uint8_t *current_compressed_data = const_cast<uint8_t *>(
-          reinterpret_cast<const uint8_t *const>(compressed_data));
-      while (current_compressed_data_size && result) {
-        sres = heatshrink_decoder_sink(
-            decompression, reinterpret_cast<uint8_t *>(current_compressed_data),
-            current_compressed_data_size, &size);
-        result = (sres >= 0) && (size <= current_compressed_data_size);
+    heatshrink_decoder_reset(decoder_);
+    size_t size{0};
+    uint64_t bytes = 0;
+    HSD_sink_res sres;
+    HSD_poll_res pres;
+    HSD_finish_res fres;
+    uint64_t current_compressed_data_size{compressed_data_size};
+    uint8_t *current_compressed_data = const_cast<uint8_t *>(
+        reinterpret_cast<const uint8_t *const>(compressed_data));
+    while (current_compressed_data_size && result) {
+      sres = heatshrink_decoder_sink(decoder_, current_compressed_data,
+                                     current_compressed_data_size, &size);
+      result = (sres >= 0) && (size <= current_compressed_data_size);
+      if (result && size) {
+        current_compressed_data += size;
+        current_compressed_data_size -= size;
+      }
+      if (!current_compressed_data_size && result) {
+        fres = heatshrink_decoder_finish(decoder_);
+        result = (fres == HSDR_FINISH_MORE);
+      }
+      for (pres = HSDR_POLL_MORE; pres == HSDR_POLL_MORE && result;) {
+        pres = heatshrink_decoder_poll(
+            decoder_, reinterpret_cast<uint8_t *>(decompressed_data),
+            *decompressed_data_size - bytes, &size);
+        result = (pres >= 0) && (bytes + size <= *decompressed_data_size);
         if (result && size) {
-          current_compressed_data += size;
-          current_compressed_data_size -= size;
-        }
-        if (!current_compressed_data_size && result) {
-          fres = heatshrink_decoder_finish(decompression);
-          result = (fres == HSDR_FINISH_MORE);
-        }
-        for (pres = HSDR_POLL_MORE; pres == HSDR_POLL_MORE && result;) {
-          pres = heatshrink_decoder_poll(
-              decompression, reinterpret_cast<uint8_t *>(decompressed_data),
-              *decompressed_data_size, &size);
-          result = (pres >= 0) && (bytes + size <= *decompressed_data_size);
-          if (result && size) {
-            bytes += size;
-            decompressed_data += size;
-          }
+          bytes += size;
+          decompressed_data += size;
         }
       }
-      if (result) {
-        fres = heatshrink_decoder_finish(decompression);
-        if (fres < 0 || fres != HSDR_FINISH_DONE ||
-            bytes > *decompressed_data_size) {
-          result = false;
-        }
+    }
+    if (result) {
+      fres = heatshrink_decoder_finish(decoder_);
+      if (fres < 0 || fres != HSDR_FINISH_DONE ||
+          bytes > *decompressed_data_size) {
+        result = false;
       }
-      *decompressed_data_size = bytes;
-      heatshrink_decoder_free(decompression);
     }
+    *decompressed_data_size = bytes;
+    heatshrink_decoder_reset(decoder_);
     if (!result) {
       std::cout << "ERROR: heatshrink error when decompress data" << std::endl;
     }
@@ -142,6 +161,74 @@ bool HeatshrinkLibrary::Decompress(const char *const compressed_data,
   return result;
 }
 
+bool HeatshrinkLibrary::Sink(const char *const data, const uint64_t &data_size,
+                             uint64_t *sunk_data_size) {
+  bool result{false};
+  size_t size{0};
+  uint8_t *current_data =
+      const_cast<uint8_t *>(reinterpret_cast<const uint8_t *const>(data));
+  if (initialized_compressor_) {
+    result = (heatshrink_encoder_sink(encoder_, current_data, data_size,
+                                      &size) >= 0);
+  } else if (initialized_decompressor_) {
+    result = (heatshrink_decoder_sink(decoder_, current_data, data_size,
+                                      &size) >= 0);
+  }
+  *sunk_data_size = size;
+  if (!result) {
+    std::cout << "ERROR: heatshrink error when sink data" << std::endl;
+  }
+  return result;
+}
+
+bool HeatshrinkLibrary::Poll(char *data, uint64_t *data_size,
+                             bool *more_data) {
+  bool result{false};
+  size_t size{0};
+  *more_data = false;
+  if (initialized_compressor_) {
+    HSE_poll_res pres = heatshrink_encoder_poll(
+        encoder_, reinterpret_cast<uint8_t *>(data), *data_size, &size);
+    result = (pres >= 0);
+    *more_data = (pres == HSER_POLL_MORE);
+  } else if (initialized_decompressor_) {
+    HSD_poll_res pres = heatshrink_decoder_poll(
+        decoder_, reinterpret_cast<uint8_t *>(data), *data_size, &size);
+    result = (pres >= 0);
+    *more_data = (pres == HSDR_POLL_MORE);
+  }
+  *data_size = size;
+  if (!result) {
+    std::cout << "ERROR: heatshrink error when poll data" << std::endl;
+  }
+  return result;
+}
+
+bool HeatshrinkLibrary::Finish(bool *finished) {
+  bool result{false};
+  *finished = false;
+  if (initialized_compressor_) {
+    HSE_finish_res fres = heatshrink_encoder_finish(encoder_);
+    result = (fres >= 0);
+    // The session is ready for the next message
+    *finished = (fres == HSER_FINISH_DONE);
+    if (*finished) {
+      heatshrink_encoder_reset(encoder_);
+    }
+  } else if (initialized_decompressor_) {
+    HSD_finish_res fres = heatshrink_decoder_finish(decoder_);
+    result = (fres >= 0);
+    *finished = (fres == HSDR_FINISH_DONE);
+    if (*finished) {
+      heatshrink_decoder_reset(decoder_);
+    }
+  }
+  if (!result) {
+    std::cout << "ERROR: heatshrink error when finish data" << std::endl;
+  }
+  return result;
+}
+
 void HeatshrinkLibrary::GetTitle() {
   CpuCompressionLibrary::GetTitle("heatshrink",
                                   "LZ77-based compression library targeted at "
@@ -175,6 +262,23 @@ bool HeatshrinkLibrary::GetBackReferenceInformation(
   return true;
 }
 
-HeatshrinkLibrary::HeatshrinkLibrary() {}
+// The sessions keep the window between the calls of the incremental mode
+bool HeatshrinkLibrary::IsStateless() { return false; }
+
+void HeatshrinkLibrary::FreeSessions() {
+  if (encoder_) {
+    heatshrink_encoder_free(encoder_);
+    encoder_ = nullptr;
+  }
+  if (decoder_) {
+    heatshrink_decoder_free(decoder_);
+    decoder_ = nullptr;
+  }
+}
+
+HeatshrinkLibrary::HeatshrinkLibrary() {
+  encoder_ = nullptr;
+  decoder_ = nullptr;
+}
 
-HeatshrinkLibrary::~HeatshrinkLibrary() {}
+HeatshrinkLibrary::~HeatshrinkLibrary() { FreeSessions(); }
@@ -23,6 +23,8 @@ class LibbscLibrary : public CpuCompressionLibrary {
   std::string *flags_;
   std::string *modes_;
 
+  int GetFeatures(uint32_t *number_threads);
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
@@ -9,9 +9,15 @@
 #include <functional>
 // Necessary to compile with libbsc
 #include <libbsc/libbsc.h>  // NOLINT
+#ifdef LIBBSC_OPENMP
+#include <omp.h>
+
+#include <thread>
+#endif  // LIBBSC_OPENMP
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
+#include <cpu_thread_budget.hpp>
 #include <libbsc_library.hpp>
 
 bool LibbscLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
@@ -35,6 +41,27 @@ bool LibbscLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   return result;
 }
 
+int LibbscLibrary::GetFeatures(uint32_t *number_threads) {
+  int features = options_.GetFlags();
+  *number_threads = 1;
+#ifdef LIBBSC_OPENMP
+  if (features & LIBBSC_FEATURE_MULTITHREADING) {
+    // OpenMP uses a thread per core by default
+    *number_threads =
+        CpuThreadBudget::AcquireThreads(std::thread::hardware_concurrency());
+    if (*number_threads > 1) {
+      omp_set_num_threads(*number_threads);
+    } else {
+      features &= ~LIBBSC_FEATURE_MULTITHREADING;
+    }
+  }
+#else
+  // Without OpenMP, libbsc runs in the calling thread only
+  features &= ~LIBBSC_FEATURE_MULTITHREADING;
+#endif  // LIBBSC_OPENMP
+  return features;
+}
+
 void LibbscLibrary::GetCompressedDataSize(
     const char *const uncompressed_data, const uint64_t &uncompressed_data_size,
     uint64_t *compressed_data_size) {
@@ -47,7 +74,9 @@ bool LibbscLibrary::Compress(const char *const uncompressed_data,
                              uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    if (result = (bsc_init(options_.GetFlags()) == LIBBSC_NO_ERROR)) {
+    uint32_t number_threads{1};
+    int features = GetFeatures(&number_threads);
+    if (result = (bsc_init(features) == LIBBSC_NO_ERROR)) {
       int res = bsc_compress(
           reinterpret_cast<const unsigned char *const>(uncompressed_data),
           reinterpret_cast<unsigned char *>(compressed_data),
@@ -55,12 +84,13 @@ bool LibbscLibrary::Compress(const char *const uncompressed_data,
           (1 << options_.GetBackReference()) - 1,
           (options_.GetMode() == 1) ? options_.GetMode()
                                     : options_.GetMode() + 1,
-          options_.GetCompressionLevel(), options_.GetFlags());
+          options_.GetCompressionLevel(), features);
       if (res == LIBBSC_NOT_COMPRESSIBLE || res < LIBBSC_NO_ERROR) {
         result = false;
       }
       *compressed_data_size = res;
     }
+    CpuThreadBudget::ReleaseThreads(number_threads);
   }
   if (!result) {
     std::cout << "ERROR: libbsc error when compress data" << std::endl;
@@ -87,19 +117,22 @@ bool LibbscLibrary::Decompress(const char *const compressed_data,
                                char *decompressed_data,
                                uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
-  if (result = (bsc_init(options_.GetFlags()) == LIBBSC_NO_ERROR)) {
+  uint32_t number_threads{1};
+  int features = GetFeatures(&number_threads);
+  if (result && (result = (bsc_init(features) == LIBBSC_NO_ERROR))) {
     GetDecompressedDataSize(compressed_data, compressed_data_size,
                             decompressed_data_size);
     int res = bsc_decompress(
         reinterpret_cast<const unsigned char *const>(compressed_data),
         compressed_data_size,
         reinterpret_cast<unsigned char *>(decompressed_data),
-        *decompressed_data_size, options_.GetFlags());
+        *decompressed_data_size, features);
     if (res < LIBBSC_NO_ERROR) {
       std::cout << "ERROR: libbsc error when decompress data" << std::endl;
       result = false;
     }
   }
+  CpuThreadBudget::ReleaseThreads(number_threads);
   return result;
 }
 
@@ -20,6 +20,22 @@ class LodepngLibrary : public CpuCompressionLibrary {
  private:
   uint8_t number_of_flags_;
   std::string *flags_;
+  unsigned char *buffer_;
+
+  uint32_t Adler32(const unsigned char *const data, const uint64_t &data_size);
+
+  bool GetImageSize(const uint64_t &data_size, uint8_t *pixel_size,
+                    uint32_t *width, uint32_t *height);
+
+  bool CompressImage(const char *const uncompressed_data,
+                     const uint8_t &pixel_size, const uint32_t &width,
+                     const uint32_t &height, char *compressed_data,
+                     uint64_t *compressed_data_size);
+
+  bool DecompressImage(const char *const compressed_data,
+                       const uint64_t &compressed_data_size,
+                       char *decompressed_data,
+                       uint64_t *decompressed_data_size);
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
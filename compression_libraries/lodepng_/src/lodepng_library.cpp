@@ -12,6 +12,136 @@
 #include <cpu_options.hpp>
 #include <lodepng_library.hpp>
 
+uint32_t LodepngLibrary::Adler32(const unsigned char *const data,
+                                 const uint64_t &data_size) {
+  uint32_t s1 = 1, s2 = 0;
+  const unsigned char *ptr = data;
+  uint64_t remaining = data_size;
+  while (remaining) {
+    // 5552 is the largest block that cannot overflow s2 before the modulo
+    uint64_t block = (remaining > 5552) ? 5552 : remaining;
+    remaining -= block;
+    while (block--) {
+      s1 += *ptr++;
+      s2 += s1;
+    }
+    s1 %= 65521;
+    s2 %= 65521;
+  }
+  return (s2 << 16) | s1;
+}
+
+static LodePNGCompressSettings GetCompressSettings(const CpuOptions &options) {
+  LodePNGCompressSettings settings = {
+      options.GetCompressionLevel(),
+      1,
+      static_cast<unsigned>(1 << options.GetWindowSize()),
+      options.GetWorkFactor(),
+      static_cast<unsigned int>((1 << options.GetBackReference()) - 1),
+      options.GetFlags(),
+      0,
+      0,
+      0};
+  return settings;
+}
+
+bool LodepngLibrary::GetImageSize(const uint64_t &data_size,
+                                  uint8_t *pixel_size, uint32_t *width,
+                                  uint32_t *height) {
+  // Data with 2 or more dimensions is compressed as an image, whose pixels
+  // are the elements, so the filters of PNG use the previous row
+  std::vector<uint64_t> shape = options_.GetShape();
+  bool result{options_.ShapeIsSet() && shape.size() >= 2 && shape[0] > 0};
+  if (result) {
+    uint64_t number_of_elements{1};
+    for (const auto &dimension : shape) number_of_elements *= dimension;
+    *pixel_size = 1;
+    if (options_.ElementSizeIsSet()) {
+      *pixel_size = options_.GetElementSize();
+    } else if (options_.DataTypeIsSet()) {
+      *pixel_size = options_.GetDataTypeSize();
+    }
+    const uint64_t row_size = data_size / shape[0];
+    // Narrow rows do not take advantage of the filters
+    result = (*pixel_size == 1 || *pixel_size == 2 || *pixel_size == 4 ||
+              *pixel_size == 8) &&
+             number_of_elements * *pixel_size == data_size &&
+             row_size >= 8 && shape[0] < (1U << 31) &&
+             row_size / *pixel_size < (1U << 31);
+    if (result) {
+      *width = static_cast<uint32_t>(row_size / *pixel_size);
+      *height = static_cast<uint32_t>(shape[0]);
+    }
+  }
+  return result;
+}
+
+bool LodepngLibrary::CompressImage(const char *const uncompressed_data,
+                                   const uint8_t &pixel_size,
+                                   const uint32_t &width,
+                                   const uint32_t &height,
+                                   char *compressed_data,
+                                   uint64_t *compressed_data_size) {
+  LodePNGState state;
+  lodepng_state_init(&state);
+  // Grey or RGBA pixels of 8 or 16 bits, so every pixel is one element
+  state.info_raw.colortype = (pixel_size <= 2) ? LCT_GREY : LCT_RGBA;
+  state.info_raw.bitdepth = (pixel_size == 1 || pixel_size == 4) ? 8 : 16;
+  state.info_png.color.colortype = state.info_raw.colortype;
+  state.info_png.color.bitdepth = state.info_raw.bitdepth;
+  state.encoder.auto_convert = 0;
+  state.encoder.zlibsettings = GetCompressSettings(options_);
+  unsigned char *data{nullptr};
+  size_t data_size{0};
+  unsigned int lodepng_result = lodepng_encode(
+      &data, &data_size,
+      reinterpret_cast<const unsigned char *const>(uncompressed_data), width,
+      height, &state);
+  lodepng_state_cleanup(&state);
+  bool result{lodepng_result == 0 && data_size <= *compressed_data_size};
+  if (result) {
+    memcpy(compressed_data, data, data_size);
+    *compressed_data_size = data_size;
+  }
+  free(data);
+  return result;
+}
+
+bool LodepngLibrary::DecompressImage(const char *const compressed_data,
+                                     const uint64_t &compressed_data_size,
+                                     char *decompressed_data,
+                                     uint64_t *decompressed_data_size) {
+  LodePNGState state;
+  lodepng_state_init(&state);
+  state.decoder.color_convert = 0;
+  unsigned char *data{nullptr};
+  unsigned width{0}, height{0};
+  const unsigned char *const input =
+      reinterpret_cast<const unsigned char *const>(compressed_data);
+  // The size of the image is checked before decoding it
+  bool result{
+      lodepng_inspect(&width, &height, &state, input, compressed_data_size) ==
+          0 &&
+      lodepng_get_raw_size(width, height, &state.info_png.color) <=
+          *decompressed_data_size};
+  if (result) {
+    result = lodepng_decode(&data, &width, &height, &state, input,
+                            compressed_data_size) == 0;
+  }
+  if (result) {
+    uint64_t data_size =
+        lodepng_get_raw_size(width, height, &state.info_png.color);
+    result = data_size <= *decompressed_data_size;
+    if (result) {
+      memcpy(decompressed_data, data, data_size);
+      *decompressed_data_size = data_size;
+    }
+  }
+  free(data);
+  lodepng_state_cleanup(&state);
+  return result;
+}
+
 bool LodepngLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   if (compressor) {
@@ -41,31 +171,44 @@ bool LodepngLibrary::Compress(const char *const uncompressed_data,
                               char *compressed_data,
                               uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
-  if (result) {
-    LodePNGCompressSettings settings = {
-        options_.GetCompressionLevel(),
-        1,
-        static_cast<unsigned>(1 << options_.GetWindowSize()),
-        options_.GetWorkFactor(),
-        static_cast<unsigned int>((1 << options_.GetBackReference()) - 1),
-        options_.GetFlags(),
-        0,
-        0,
-        0};
-
-    unsigned char *data{nullptr};
+  uint8_t pixel_size{0};
+  uint32_t width{0}, height{0};
+  if (result && GetImageSize(uncompressed_data_size, &pixel_size, &width,
+                             &height)) {
+    result = CompressImage(uncompressed_data, pixel_size, width, height,
+                           compressed_data, compressed_data_size);
+    if (!result) {
+      std::cout << "ERROR: lodepng error when compress data" << std::endl;
+    }
+  } else if (result) {
+    LodePNGCompressSettings settings = GetCompressSettings(options_);
+
+    // Deflate into the reused buffer and wrap it with the zlib header and
+    // the Adler-32 trailer while copying it out. lodepng appends after the
+    // given size and takes it as the capacity, so the buffer starts empty
+    // and is reallocated as the output grows in every call
+    unsigned char *data{buffer_};
     uint64_t data_size = 0;
-    unsigned int lodepng_result = lodepng_zlib_compress(
+    unsigned int lodepng_result = lodepng_deflate(
         &data, &data_size,
         reinterpret_cast<const unsigned char *const>(uncompressed_data),
         uncompressed_data_size, &settings);
-    if (lodepng_result != 0 || data_size > *compressed_data_size) {
+    buffer_ = data;
+    if (lodepng_result != 0 || data_size + 6 > *compressed_data_size) {
       std::cout << "ERROR: lodepng error when compress data" << std::endl;
       result = false;
     } else {
-      *compressed_data_size = data_size;
-      memcpy(compressed_data, data, data_size);
-      free(data);
+      uint32_t adler = Adler32(
+          reinterpret_cast<const unsigned char *const>(uncompressed_data),
+          uncompressed_data_size);
+      compressed_data[0] = 0x78;
+      compressed_data[1] = 0x01;
+      memcpy(compressed_data + 2, data, data_size);
+      compressed_data[data_size + 2] = (adler >> 24) & 0xFF;
+      compressed_data[data_size + 3] = (adler >> 16) & 0xFF;
+      compressed_data[data_size + 4] = (adler >> 8) & 0xFF;
+      compressed_data[data_size + 5] = adler & 0xFF;
+      *compressed_data_size = data_size + 6;
     }
   }
   return result;
@@ -76,21 +219,31 @@ bool LodepngLibrary::Decompress(const char *const compressed_data,
                                 char *decompressed_data,
                                 uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
-  if (result) {
+  // Images are found by the signature of PNG, the rest of data is zlib
+  static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+  if (result && compressed_data_size >= sizeof(signature) &&
+      memcmp(compressed_data, signature, sizeof(signature)) == 0) {
+    result = DecompressImage(compressed_data, compressed_data_size,
+                             decompressed_data, decompressed_data_size);
+    if (!result) {
+      std::cout << "ERROR: lodepng error when decompress data" << std::endl;
+    }
+  } else if (result) {
     LodePNGDecompressSettings settings = {0, 0, 0, 0, 0, 0};
-    unsigned char *data{nullptr};
+    settings.max_output_size = *decompressed_data_size;
+    unsigned char *data{buffer_};
     uint64_t data_size = 0;
     unsigned int lodepng_result = lodepng_zlib_decompress(
         &data, &data_size,
         reinterpret_cast<const unsigned char *const>(compressed_data),
         compressed_data_size, &settings);
+    buffer_ = data;
     if (lodepng_result != 0 || data_size > *decompressed_data_size) {
       std::cout << "ERROR: lodepng error when decompress data" << std::endl;
       result = false;
     } else {
       *decompressed_data_size = data_size;
       memcpy(decompressed_data, data, data_size);
-      free(data);
     }
   }
   return result;
@@ -181,6 +334,10 @@ LodepngLibrary::LodepngLibrary() {
   flags_ = new std::string[number_of_flags_];
   flags_[0] = "Fast";
   flags_[1] = "Slow";
+  buffer_ = nullptr;
 }
 
-LodepngLibrary::~LodepngLibrary() { delete[] flags_; }
+LodepngLibrary::~LodepngLibrary() {
+  delete[] flags_;
+  if (buffer_) free(buffer_);
+}
@@ -16,10 +16,16 @@
 #include <cpu_compression_library.hpp>
 #include <cpu_options.hpp>
 
+union LZ4_stream_u;
+union LZ4_streamHC_u;
+
 class Lz4Library : public CpuCompressionLibrary {
  private:
   uint8_t number_of_modes_;
   std::string *modes_;
+  // Streams for the compression against a reference
+  LZ4_stream_u *stream_;
+  LZ4_streamHC_u *stream_hc_;
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
@@ -36,6 +42,19 @@ class Lz4Library : public CpuCompressionLibrary {
                   const uint64_t &compressed_data_size, char *decompressed_data,
                   uint64_t *decompressed_data_size);
 
+  bool CompressAgainst(const char *const reference_data,
+                       const uint64_t &reference_data_size,
+                       const char *const uncompressed_data,
+                       const uint64_t &uncompressed_data_size,
+                       char *compressed_data, uint64_t *compressed_data_size);
+
+  bool DecompressAgainst(const char *const reference_data,
+                         const uint64_t &reference_data_size,
+                         const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size);
+
   void GetTitle();
 
   bool GetCompressionLevelInformation(
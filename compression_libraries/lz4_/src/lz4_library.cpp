@@ -13,6 +13,9 @@
 #include <cpu_options.hpp>
 #include <lz4_library.hpp>
 
+// The window of lz4, which is the most of a dictionary it can use
+static const uint64_t kMaximumDictionarySize = 64 * 1024;
+
 bool Lz4Library::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   if (compressor) {
@@ -76,6 +79,71 @@ bool Lz4Library::Decompress(const char *const compressed_data,
   return result;
 }
 
+bool Lz4Library::CompressAgainst(const char *const reference_data,
+                                 const uint64_t &reference_data_size,
+                                 const char *const uncompressed_data,
+                                 const uint64_t &uncompressed_data_size,
+                                 char *compressed_data,
+                                 uint64_t *compressed_data_size) {
+  // A larger reference is XORed with the data
+  if (reference_data_size > kMaximumDictionarySize) {
+    return CpuCompressionLibrary::CompressAgainst(
+        reference_data, reference_data_size, uncompressed_data,
+        uncompressed_data_size, compressed_data, compressed_data_size);
+  }
+  bool result{initialized_compressor_};
+  if (result) {
+    int bytes_returned{0};
+    if (options_.GetMode()) {
+      if (!stream_hc_) stream_hc_ = LZ4_createStreamHC();
+      LZ4_resetStreamHC_fast(stream_hc_, options_.GetCompressionLevel());
+      LZ4_loadDictHC(stream_hc_, reference_data, reference_data_size);
+      bytes_returned = LZ4_compress_HC_continue(
+          stream_hc_, uncompressed_data, compressed_data,
+          uncompressed_data_size, *compressed_data_size);
+    } else {
+      if (!stream_) stream_ = LZ4_createStream();
+      LZ4_resetStream_fast(stream_);
+      LZ4_loadDict(stream_, reference_data, reference_data_size);
+      bytes_returned = LZ4_compress_fast_continue(
+          stream_, uncompressed_data, compressed_data, uncompressed_data_size,
+          *compressed_data_size,
+          1 << static_cast<int>(options_.GetCompressionLevel() * 1.4));
+    }
+    result = (bytes_returned > 0);
+    if (!result) {
+      std::cout << "ERROR: lz4 error when compress data" << std::endl;
+    }
+    *compressed_data_size = bytes_returned;
+  }
+  return result;
+}
+
+bool Lz4Library::DecompressAgainst(const char *const reference_data,
+                                   const uint64_t &reference_data_size,
+                                   const char *const compressed_data,
+                                   const uint64_t &compressed_data_size,
+                                   char *decompressed_data,
+                                   uint64_t *decompressed_data_size) {
+  if (reference_data_size > kMaximumDictionarySize) {
+    return CpuCompressionLibrary::DecompressAgainst(
+        reference_data, reference_data_size, compressed_data,
+        compressed_data_size, decompressed_data, decompressed_data_size);
+  }
+  bool result{initialized_decompressor_};
+  if (result) {
+    int bytes_returned = LZ4_decompress_safe_usingDict(
+        compressed_data, decompressed_data, compressed_data_size,
+        *decompressed_data_size, reference_data, reference_data_size);
+    if (bytes_returned < 1) {
+      std::cout << "ERROR: lz4 error when decompress data" << std::endl;
+      result = false;
+    }
+    *decompressed_data_size = bytes_returned;
+  }
+  return result;
+}
+
 void Lz4Library::GetTitle() {
   CpuCompressionLibrary::GetTitle(
       "lz4", "Extremely fast lossless compression library based on LZ77");
@@ -118,11 +186,15 @@ std::string Lz4Library::GetModeName(const uint8_t &mode) {
   return result;
 }
 
-Lz4Library::Lz4Library() {
+Lz4Library::Lz4Library() : stream_(nullptr), stream_hc_(nullptr) {
   number_of_modes_ = 2;
   modes_ = new std::string[number_of_modes_];
   modes_[0] = "Fast";
   modes_[1] = "HC";
 }
 
-Lz4Library::~Lz4Library() { delete[] modes_; }
+Lz4Library::~Lz4Library() {
+  delete[] modes_;
+  if (stream_) LZ4_freeStream(stream_);
+  if (stream_hc_) LZ4_freeStreamHC(stream_hc_);
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <lzham.h>
+
 #include <iostream>
 #include <string>
 #include <vector>
@@ -21,10 +23,20 @@ class LzhamLibrary : public CpuCompressionLibrary {
   uint8_t number_of_flags_;
   std::string *flags_;
   uint8_t *flags_values_;
+  lzham_compress_state_ptr compressor_;
+  lzham_decompress_state_ptr decompressor_;
+  lzham_decompress_params decompressor_params_;
+  uint32_t number_threads_;
+
+  void DestroyStates();
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
   bool Compress(const char *const uncompressed_data,
                 const uint64_t &uncompressed_data_size, char *compressed_data,
                 uint64_t *compressed_data_size);
@@ -47,8 +59,14 @@ class LzhamLibrary : public CpuCompressionLibrary {
       std::vector<std::string> *flags_information = nullptr,
       uint8_t *minimum_flags = nullptr, uint8_t *maximum_flags = nullptr);
 
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr);
+
   std::string GetFlagsName(const uint8_t &flags);
 
+  void Reset();
+
   LzhamLibrary();
   ~LzhamLibrary();
 };
@@ -9,6 +9,7 @@
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
+#include <cpu_thread_budget.hpp>
 #include <lzham_library.hpp>
 
 bool LzhamLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
@@ -19,23 +20,43 @@ bool LzhamLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
         CpuCompressionLibrary::CheckCompressionLevel("lzham", options, 0, 4);
     if (result) {
       result = CpuCompressionLibrary::CheckFlags("lzham", options, 0, 7);
+      if (result) {
+        result =
+            CpuCompressionLibrary::CheckNumberThreads("lzham", options, 1, 8);
+      }
     }
   }
   return result;
 }
 
-bool LzhamLibrary::Compress(const char *const uncompressed_data,
-                            const uint64_t &uncompressed_data_size,
-                            char *compressed_data,
-                            uint64_t *compressed_data_size) {
-  bool result{initialized_compressor_};
-  if (result) {
+void LzhamLibrary::DestroyStates() {
+  if (compressor_) {
+    lzham_compress_deinit(compressor_);
+    compressor_ = nullptr;
+    CpuThreadBudget::ReleaseThreads(number_threads_);
+  }
+  if (decompressor_) {
+    lzham_decompress_deinit(decompressor_);
+    decompressor_ = nullptr;
+  }
+}
+
+bool LzhamLibrary::SetOptionsCompressor(CpuOptions *options) {
+  DestroyStates();
+  initialized_decompressor_ = false;
+  initialized_compressor_ = CheckOptions(options, true);
+  if (initialized_compressor_) {
+    options_ = *options;
     lzham_compress_params params;
     params.m_struct_size = sizeof(params);
     params.m_dict_size_log2 = options_.GetWindowSize();
     params.m_level =
         static_cast<lzham_compress_level>(options_.GetCompressionLevel());
-    params.m_max_helper_threads = -1;
+    // The calling thread is always used, the rest are helper threads that
+    // live with the compressor, so they are borrowed until it is destroyed
+    number_threads_ =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
+    params.m_max_helper_threads = number_threads_ - 1;
     params.m_num_seed_bytes = 0;
     params.m_pSeed_bytes = NULL;
     params.m_table_update_interval_slow_rate = 0;
@@ -45,16 +66,75 @@ bool LzhamLibrary::Compress(const char *const uncompressed_data,
     params.m_extreme_parsing_max_best_arrivals = 0;
     params.m_fast_bytes = 0;
 
-    lzham_compress_status_t lzham_result = lzham_compress_memory(
-        &params, reinterpret_cast<unsigned char *>(compressed_data),
-        compressed_data_size,
+    compressor_ = lzham_compress_init(&params);
+    if (!compressor_) {
+      CpuThreadBudget::ReleaseThreads(number_threads_);
+      std::cout << "ERROR: lzham error when initialize the compressor"
+                << std::endl;
+      initialized_compressor_ = false;
+    }
+  }
+  return initialized_compressor_;
+}
+
+bool LzhamLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  DestroyStates();
+  initialized_compressor_ = false;
+  initialized_decompressor_ = CheckOptions(options, false);
+  if (initialized_decompressor_) {
+    options_ = *options;
+    decompressor_params_.m_struct_size = sizeof(decompressor_params_);
+    decompressor_params_.m_dict_size_log2 = options_.GetWindowSize();
+    decompressor_params_.m_table_update_rate = 0;
+    // The whole output buffer is always available, so lzham decodes straight
+    // into it instead of through its internal dictionary buffer
+    decompressor_params_.m_decompress_flags =
+        LZHAM_DECOMP_FLAG_OUTPUT_UNBUFFERED;
+    decompressor_params_.m_num_seed_bytes = 0;
+    decompressor_params_.m_pSeed_bytes = NULL;
+    decompressor_params_.m_table_max_update_interval = 0;
+    decompressor_params_.m_table_update_interval_slow_rate = 0;
+
+    decompressor_ = lzham_decompress_init(&decompressor_params_);
+    if (!decompressor_) {
+      std::cout << "ERROR: lzham error when initialize the decompressor"
+                << std::endl;
+      initialized_decompressor_ = false;
+    }
+  }
+  return initialized_decompressor_;
+}
+
+bool LzhamLibrary::Compress(const char *const uncompressed_data,
+                            const uint64_t &uncompressed_data_size,
+                            char *compressed_data,
+                            uint64_t *compressed_data_size) {
+  bool result{initialized_compressor_};
+  if (result) {
+    size_t in_size = uncompressed_data_size;
+    size_t out_size = *compressed_data_size;
+    lzham_compress_status_t lzham_result = lzham_compress(
+        compressor_,
         reinterpret_cast<const unsigned char *const>(uncompressed_data),
-        uncompressed_data_size, NULL);
+        &in_size, reinterpret_cast<unsigned char *>(compressed_data),
+        &out_size, true);
 
     if (lzham_result != LZHAM_COMP_STATUS_SUCCESS) {
       std::cout << "ERROR: lzham error when compress data" << std::endl;
       result = false;
+    } else {
+      *compressed_data_size = out_size;
+    }
+    // Reset the models and tables for the next call without reallocating them
+    lzham_compress_state_ptr compressor = lzham_compress_reinit(compressor_);
+    if (!compressor) {
+      // The state is not freed by a failed reinit, and DestroyStates only
+      // returns the threads of a live compressor
+      lzham_compress_deinit(compressor_);
+      CpuThreadBudget::ReleaseThreads(number_threads_);
+      initialized_compressor_ = false;
     }
+    compressor_ = compressor;
   }
   return result;
 }
@@ -65,26 +145,28 @@ bool LzhamLibrary::Decompress(const char *const compressed_data,
                               uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
   if (result) {
-    lzham_decompress_params params;
-    params.m_struct_size = sizeof(params);
-    params.m_dict_size_log2 = options_.GetWindowSize();
-    params.m_table_update_rate = 0;
-    params.m_decompress_flags = 0;
-    params.m_num_seed_bytes = 0;
-    params.m_pSeed_bytes = NULL;
-    params.m_table_max_update_interval = 0;
-    params.m_table_update_interval_slow_rate = 0;
-
-    lzham_decompress_status_t lzham_result = lzham_decompress_memory(
-        &params, reinterpret_cast<unsigned char *>(decompressed_data),
-        decompressed_data_size,
+    size_t in_size = compressed_data_size;
+    size_t out_size = *decompressed_data_size;
+    lzham_decompress_status_t lzham_result = lzham_decompress(
+        decompressor_,
         reinterpret_cast<const unsigned char *const>(compressed_data),
-        compressed_data_size, NULL);
+        &in_size, reinterpret_cast<unsigned char *>(decompressed_data),
+        &out_size, true);
 
     if (lzham_result != LZHAM_DECOMP_STATUS_SUCCESS) {
       std::cout << "ERROR: lzham error when decompress data" << std::endl;
       result = false;
+    } else {
+      *decompressed_data_size = out_size;
     }
+    // Reset the models and tables for the next call without reallocating them
+    lzham_decompress_state_ptr decompressor =
+        lzham_decompress_reinit(decompressor_, &decompressor_params_);
+    if (!decompressor) {
+      lzham_decompress_deinit(decompressor_);
+      initialized_decompressor_ = false;
+    }
+    decompressor_ = decompressor;
   }
   return result;
 }
@@ -142,6 +224,19 @@ bool LzhamLibrary::GetFlagsInformation(
   return true;
 }
 
+bool LzhamLibrary::GetNumberThreadsInformation(
+    std::vector<std::string> *number_threads_information,
+    uint8_t *minimum_threads, uint8_t *maximum_threads) {
+  if (minimum_threads) *minimum_threads = 1;
+  if (maximum_threads) *maximum_threads = 8;
+  if (number_threads_information) {
+    number_threads_information->clear();
+    number_threads_information->push_back("Available values [1-8]");
+    number_threads_information->push_back("[compression]");
+  }
+  return true;
+}
+
 std::string LzhamLibrary::GetFlagsName(const uint8_t &flags) {
   std::string result = "ERROR";
   if (flags < number_of_flags_) {
@@ -150,7 +245,16 @@ std::string LzhamLibrary::GetFlagsName(const uint8_t &flags) {
   return result;
 }
 
+// The states are made with the options and the compressor borrows threads
+void LzhamLibrary::Reset() {
+  DestroyStates();
+  CpuCompressionLibrary::Reset();
+}
+
 LzhamLibrary::LzhamLibrary() {
+  compressor_ = nullptr;
+  decompressor_ = nullptr;
+  number_threads_ = 1;
   number_of_flags_ = 8;
   flags_ = new std::string[number_of_flags_];
   flags_values_ = new uint8_t[number_of_flags_];
@@ -173,6 +277,7 @@ LzhamLibrary::LzhamLibrary() {
 }
 
 LzhamLibrary::~LzhamLibrary() {
+  DestroyStates();
   delete[] flags_;
   delete[] flags_values_;
 }
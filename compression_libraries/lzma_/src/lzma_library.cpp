@@ -10,6 +10,7 @@
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
+#include <cpu_thread_budget.hpp>
 #include <lzma_library.hpp>
 
 bool LzmaLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
@@ -43,7 +44,8 @@ bool LzmaLibrary::Compress(const char *const uncompressed_data,
     config.block_size = 0;
     config.timeout = 0;
     config.check = LZMA_CHECK_CRC64;
-    config.threads = options_.GetNumberThreads();
+    config.threads =
+        CpuThreadBudget::AcquireThreads(options_.GetNumberThreads());
     switch (options_.GetMode()) {
       case 0:
         config.preset = LZMA_PRESET_DEFAULT;
@@ -93,6 +95,7 @@ bool LzmaLibrary::Compress(const char *const uncompressed_data,
       }
     }
     lzma_end(&strm);
+    CpuThreadBudget::ReleaseThreads(config.threads);
     if (!result) {
       std::cout << "ERROR: lzma error when compress data" << std::endl;
     }
@@ -29,6 +29,8 @@ class LzoLibrary : public CpuCompressionLibrary {
  private:
   uint8_t number_of_modes_;
   std::string *modes_;
+  uint8_t number_of_flags_;
+  std::string *flags_;
 
  private:
   uint64_t compression_work_memory_size_;
@@ -39,7 +41,10 @@ class LzoLibrary : public CpuCompressionLibrary {
   int (*LZO_decompress_)(const lzo_bytep, lzo_uint, lzo_bytep, lzo_uintp,
                          lzo_voidp);
 
-  void GetFunctions(const uint8_t &mode, const uint8_t &compression_level);
+  int (*LZO_optimize_)(lzo_bytep, lzo_uint, lzo_bytep, lzo_uintp, lzo_voidp);
+
+  void GetFunctions(const uint8_t &mode, const uint8_t &compression_level,
+                    const uint8_t &flags);
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
@@ -67,8 +72,14 @@ class LzoLibrary : public CpuCompressionLibrary {
                           uint8_t *maximum_mode = nullptr,
                           const uint8_t &compression_level = 0);
 
+  bool GetFlagsInformation(
+      std::vector<std::string> *flags_information = nullptr,
+      uint8_t *minimum_flags = nullptr, uint8_t *maximum_flags = nullptr);
+
   std::string GetModeName(const uint8_t &mode);
 
+  std::string GetFlagsName(const uint8_t &flags);
+
   LzoLibrary();
   ~LzoLibrary();
 };
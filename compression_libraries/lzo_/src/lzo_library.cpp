@@ -23,6 +23,9 @@
 bool LzoLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   result = CpuCompressionLibrary::CheckMode("lzo", options, 0, 7);
+  if (result) {
+    result = CpuCompressionLibrary::CheckFlags("lzo", options, 0, 3);
+  }
   if (compressor && result) {
     switch (options->GetMode()) {
       case 0:
@@ -43,7 +46,7 @@ bool LzoLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
         break;
       case 4:
         result = CpuCompressionLibrary::CheckCompressionLevel(
-            "mode value 4 in lzo", options, 0, 4);
+            "mode value 4 in lzo", options, 0, 5);
         break;
       case 5:
         result = CpuCompressionLibrary::CheckCompressionLevel(
@@ -64,8 +67,19 @@ bool LzoLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   return result;
 }
 
+static int lzo1x_999_9_compress(const lzo_bytep in, lzo_uint in_len,
+                                lzo_bytep out, lzo_uintp out_len,
+                                lzo_voidp wrkmem) {
+  return lzo1x_999_compress_level(in, in_len, out, out_len, wrkmem, nullptr, 0,
+                                  nullptr, 9);
+}
+
 void LzoLibrary::GetFunctions(const uint8_t &mode,
-                              const uint8_t &compression_level) {
+                              const uint8_t &compression_level,
+                              const uint8_t &flags) {
+  // Without bounds checks, only for data that can be trusted
+  bool trusted = (flags & 2);
+  LZO_optimize_ = nullptr;
   switch (mode) {
     case 0: {
       decompression_work_memory_size_ = LZO1_MEM_DECOMPRESS;
@@ -107,7 +121,7 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 2: {
       decompression_work_memory_size_ = LZO1B_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1b_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1b_decompress : lzo1b_decompress_safe;
       switch (compression_level) {
         case 0: {
           compression_work_memory_size_ = LZO1B_MEM_COMPRESS;
@@ -171,7 +185,7 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 3: {
       decompression_work_memory_size_ = LZO1C_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1c_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1c_decompress : lzo1c_decompress_safe;
       switch (compression_level) {
         case 0: {
           compression_work_memory_size_ = LZO1C_MEM_COMPRESS;
@@ -235,7 +249,8 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 4: {
       decompression_work_memory_size_ = LZO1X_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1x_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1x_decompress : lzo1x_decompress_safe;
+      if (flags & 1) LZO_optimize_ = lzo1x_optimize;
       switch (compression_level) {
         case 0: {
           compression_work_memory_size_ = LZO1X_1_MEM_COMPRESS;
@@ -262,6 +277,11 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
           LZO_compress_ = lzo1x_999_compress;
           break;
         }
+        case 5: {
+          compression_work_memory_size_ = LZO1X_999_MEM_COMPRESS;
+          LZO_compress_ = lzo1x_999_9_compress;
+          break;
+        }
         default:
           break;
       }
@@ -269,7 +289,7 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 5: {
       decompression_work_memory_size_ = LZO1F_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1f_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1f_decompress : lzo1f_decompress_safe;
       switch (compression_level) {
         case 0: {
           compression_work_memory_size_ = LZO1F_MEM_COMPRESS;
@@ -288,7 +308,8 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 6: {
       decompression_work_memory_size_ = LZO1Y_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1y_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1y_decompress : lzo1y_decompress_safe;
+      if (flags & 1) LZO_optimize_ = lzo1y_optimize;
       switch (compression_level) {
         case 0: {
           compression_work_memory_size_ = LZO1Y_MEM_COMPRESS;
@@ -307,7 +328,7 @@ void LzoLibrary::GetFunctions(const uint8_t &mode,
     }
     case 7: {
       decompression_work_memory_size_ = LZO1Z_MEM_DECOMPRESS;
-      LZO_decompress_ = lzo1z_decompress_safe;
+      LZO_decompress_ = (trusted) ? lzo1z_decompress : lzo1z_decompress_safe;
       compression_work_memory_size_ = LZO1Z_999_MEM_COMPRESS;
       LZO_compress_ = lzo1z_999_compress;
       break;
@@ -322,7 +343,8 @@ bool LzoLibrary::SetOptionsCompressor(CpuOptions *options) {
   initialized_compressor_ = CheckOptions(options, true);
   if (initialized_compressor_) {
     options_ = *options;
-    GetFunctions(options_.GetMode(), options_.GetCompressionLevel());
+    GetFunctions(options_.GetMode(), options_.GetCompressionLevel(),
+                 options_.GetFlags());
   }
   return initialized_compressor_;
 }
@@ -332,7 +354,8 @@ bool LzoLibrary::SetOptionsDecompressor(CpuOptions *options) {
   initialized_decompressor_ = CheckOptions(options, false);
   if (initialized_decompressor_) {
     options_ = *options;
-    GetFunctions(options_.GetMode(), options_.GetCompressionLevel());
+    GetFunctions(options_.GetMode(), options_.GetCompressionLevel(),
+                 options_.GetFlags());
   }
   return initialized_decompressor_;
 }
@@ -353,6 +376,15 @@ bool LzoLibrary::Compress(const char *const uncompressed_data,
         uncompressed_data_size,
         reinterpret_cast<unsigned char *>(compressed_data),
         compressed_data_size, work_memory);
+    if (error == LZO_E_OK && LZO_optimize_) {
+      // Rearranges the compressed data to be decompressed faster, which
+      // needs to decompress it once
+      std::vector<unsigned char> buffer(uncompressed_data_size);
+      lzo_uint size = uncompressed_data_size;
+      error = LZO_optimize_(reinterpret_cast<unsigned char *>(compressed_data),
+                            *compressed_data_size, buffer.data(), &size,
+                            nullptr);
+    }
     if (error != LZO_E_OK) {
       std::cout << "ERROR: lzo error when compress data" << std::endl;
       result = false;
@@ -409,7 +441,7 @@ bool LzoLibrary::GetCompressionLevelInformation(
     compression_level_information->push_back("Mode " + modes_[1] + ": [0-1]");
     compression_level_information->push_back("Mode " + modes_[2] + ": [0-10]");
     compression_level_information->push_back("Mode " + modes_[3] + ": [0-10]");
-    compression_level_information->push_back("Mode " + modes_[4] + ": [0-4]");
+    compression_level_information->push_back("Mode " + modes_[4] + ": [0-5]");
     compression_level_information->push_back("Mode " + modes_[5] + ": [0-1]");
     compression_level_information->push_back("Mode " + modes_[6] + ": [0-1]");
     compression_level_information->push_back("Mode " + modes_[7] + ": [0]");
@@ -445,7 +477,7 @@ bool LzoLibrary::GetModeInformation(std::vector<std::string> *mode_information,
       break;
     case 5:
       if (minimum_mode) *minimum_mode = 2;
-      if (maximum_mode) *maximum_mode = 3;
+      if (maximum_mode) *maximum_mode = 4;
       break;
     case 6:
       if (minimum_mode) *minimum_mode = 2;
@@ -512,6 +544,28 @@ bool LzoLibrary::GetModeInformation(std::vector<std::string> *mode_information,
   return true;
 }
 
+bool LzoLibrary::GetFlagsInformation(
+    std::vector<std::string> *flags_information, uint8_t *minimum_flags,
+    uint8_t *maximum_flags) {
+  if (minimum_flags) *minimum_flags = 0;
+  if (maximum_flags) *maximum_flags = 3;
+  if (flags_information) {
+    flags_information->clear();
+    flags_information->push_back("Available values [0-3]");
+    flags_information->push_back("0: " + flags_[0]);
+    flags_information->push_back(
+        "1: " + flags_[1] +
+        " compressed data to decompress it faster (LZO1x and LZO1y) "
+        "[compression]");
+    flags_information->push_back(
+        "2: " + flags_[2] +
+        " data, decompress without bounds checks [decompression]");
+    flags_information->push_back("3: " + flags_[3] + " flags");
+    flags_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
 std::string LzoLibrary::GetModeName(const uint8_t &mode) {
   std::string result = "ERROR";
   if (mode < number_of_modes_) {
@@ -520,7 +574,16 @@ std::string LzoLibrary::GetModeName(const uint8_t &mode) {
   return result;
 }
 
+std::string LzoLibrary::GetFlagsName(const uint8_t &flags) {
+  std::string result = "ERROR";
+  if (flags < number_of_flags_) {
+    result = flags_[flags];
+  }
+  return result;
+}
+
 LzoLibrary::LzoLibrary() {
+  LZO_optimize_ = nullptr;
   compression_work_memory_size_ = 0;
   decompression_work_memory_size_ = 0;
   number_of_modes_ = 8;
@@ -533,6 +596,15 @@ LzoLibrary::LzoLibrary() {
   modes_[5] = "LZO1f";
   modes_[6] = "LZO1y";
   modes_[7] = "LZO1z";
+  number_of_flags_ = 4;
+  flags_ = new std::string[number_of_flags_];
+  flags_[0] = "None";
+  flags_[1] = "Optimize";
+  flags_[2] = "Trusted";
+  flags_[3] = "1 & 2";
 }
 
-LzoLibrary::~LzoLibrary() { delete[] modes_; }
+LzoLibrary::~LzoLibrary() {
+  delete[] modes_;
+  delete[] flags_;
+}
@@ -20,10 +20,30 @@ class LzsseLibrary : public CpuCompressionLibrary {
  private:
   uint8_t number_of_modes_;
   std::string *modes_;
+  std::vector<void *> states_;
+  uint64_t states_size_;
+
+  bool GetStates(const uint64_t &number_of_states, const uint64_t &size);
+
+  void FreeStates();
+
+  uint64_t CompressBlock(void *state, const char *const uncompressed_data,
+                         const uint64_t &uncompressed_data_size,
+                         char *compressed_data,
+                         const uint64_t &compressed_data_size);
+
+  uint64_t DecompressBlock(const char *const compressed_data,
+                           const uint64_t &compressed_data_size,
+                           char *decompressed_data,
+                           const uint64_t &decompressed_data_size);
 
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
   bool Compress(const char *const uncompressed_data,
                 const uint64_t &uncompressed_data_size, char *compressed_data,
                 uint64_t *compressed_data_size);
@@ -43,6 +63,10 @@ class LzsseLibrary : public CpuCompressionLibrary {
                           uint8_t *maximum_mode = nullptr,
                           const uint8_t &compression_level = 0);
 
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr);
+
   std::string GetModeName(const uint8_t &mode);
 
   LzsseLibrary();
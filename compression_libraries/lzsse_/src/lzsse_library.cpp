@@ -11,14 +11,23 @@
 #include <lzsse2.h>
 #include <lzsse4.h>
 #include <lzsse8.h>
+#include <string.h>
+
+#include <atomic>
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
 #include <lzsse_library.hpp>
 
+// The compressed data starts with the format of the rest: a single LZSSE
+// stream, or the block format written with more than 1 thread
+static const uint8_t kSingleBlock{0};
+static const uint8_t kBlocks{1};
+
 bool LzsseLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
-  if (compressor) {
+  result = CpuCompressionLibrary::CheckNumberThreads("lzsse", options, 1, 8);
+  if (compressor && result) {
     result =
         CpuCompressionLibrary::CheckCompressionLevel("lzsse", options, 1, 17);
     if (result) {
@@ -28,56 +37,193 @@ bool LzsseLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   return result;
 }
 
+bool LzsseLibrary::SetOptionsCompressor(CpuOptions *options) {
+  // The parse states depend on the variant, which may change
+  FreeStates();
+  return CpuCompressionLibrary::SetOptionsCompressor(options);
+}
+
+bool LzsseLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  FreeStates();
+  return CpuCompressionLibrary::SetOptionsDecompressor(options);
+}
+
+bool LzsseLibrary::GetStates(const uint64_t &number_of_states,
+                             const uint64_t &size) {
+  if (size > states_size_) {
+    FreeStates();
+    states_size_ = size;
+  }
+  bool result{true};
+  while (result && states_.size() < number_of_states) {
+    void *state{nullptr};
+    switch (options_.GetMode()) {
+      case 0:
+        state = LZSSE2_MakeOptimalParseState(states_size_);
+        break;
+      case 1:
+        state = LZSSE4_MakeOptimalParseState(states_size_);
+        break;
+      case 2:
+        state = LZSSE8_MakeOptimalParseState(states_size_);
+        break;
+      default:
+        break;
+    }
+    if (result = state) states_.push_back(state);
+  }
+  return result;
+}
+
+void LzsseLibrary::FreeStates() {
+  for (auto &state : states_) {
+    switch (options_.GetMode()) {
+      case 0:
+        LZSSE2_FreeOptimalParseState(
+            reinterpret_cast<LZSSE2_OptimalParseState *>(state));
+        break;
+      case 1:
+        LZSSE4_FreeOptimalParseState(
+            reinterpret_cast<LZSSE4_OptimalParseState *>(state));
+        break;
+      case 2:
+        LZSSE8_FreeOptimalParseState(
+            reinterpret_cast<LZSSE8_OptimalParseState *>(state));
+        break;
+      default:
+        break;
+    }
+  }
+  states_.clear();
+  states_size_ = 0;
+}
+
+uint64_t LzsseLibrary::CompressBlock(void *state,
+                                     const char *const uncompressed_data,
+                                     const uint64_t &uncompressed_data_size,
+                                     char *compressed_data,
+                                     const uint64_t &compressed_data_size) {
+  uint64_t compressed_bytes{0};
+  switch (options_.GetMode()) {
+    case 0:
+      compressed_bytes = LZSSE2_CompressOptimalParse(
+          reinterpret_cast<LZSSE2_OptimalParseState *>(state),
+          uncompressed_data, uncompressed_data_size, compressed_data,
+          compressed_data_size, options_.GetCompressionLevel());
+      break;
+    case 1:
+      compressed_bytes = LZSSE4_CompressOptimalParse(
+          reinterpret_cast<LZSSE4_OptimalParseState *>(state),
+          uncompressed_data, uncompressed_data_size, compressed_data,
+          compressed_data_size, options_.GetCompressionLevel());
+      break;
+    case 2:
+      compressed_bytes = LZSSE8_CompressOptimalParse(
+          reinterpret_cast<LZSSE8_OptimalParseState *>(state),
+          uncompressed_data, uncompressed_data_size, compressed_data,
+          compressed_data_size, options_.GetCompressionLevel());
+      break;
+    default:
+      break;
+  }
+  return compressed_bytes;
+}
+
+uint64_t LzsseLibrary::DecompressBlock(const char *const compressed_data,
+                                       const uint64_t &compressed_data_size,
+                                       char *decompressed_data,
+                                       const uint64_t &decompressed_data_size) {
+  uint64_t decompressed_bytes{0};
+  switch (options_.GetMode()) {
+    case 0:
+      decompressed_bytes =
+          LZSSE2_Decompress(compressed_data, compressed_data_size,
+                            decompressed_data, decompressed_data_size);
+      break;
+    case 1:
+      decompressed_bytes =
+          LZSSE4_Decompress(compressed_data, compressed_data_size,
+                            decompressed_data, decompressed_data_size);
+      break;
+    case 2:
+      decompressed_bytes =
+          LZSSE8_Decompress(compressed_data, compressed_data_size,
+                            decompressed_data, decompressed_data_size);
+      break;
+    default:
+      break;
+  }
+  return decompressed_bytes;
+}
+
 bool LzsseLibrary::Compress(const char *const uncompressed_data,
                             const uint64_t &uncompressed_data_size,
                             char *compressed_data,
                             uint64_t *compressed_data_size) {
-  bool result{initialized_compressor_};
+  bool result{initialized_compressor_ && *compressed_data_size > 1};
   if (result) {
     uint64_t compressed_bytes{0};
-    switch (options_.GetMode()) {
-      case 0: {
-        LZSSE2_OptimalParseState *state =
-            LZSSE2_MakeOptimalParseState(uncompressed_data_size);
-        if (result = state) {
-          compressed_bytes = LZSSE2_CompressOptimalParse(
-              state, uncompressed_data, uncompressed_data_size, compressed_data,
-              *compressed_data_size, options_.GetCompressionLevel());
-          LZSSE2_FreeOptimalParseState(state);
-        }
-        break;
-      }
-      case 1: {
-        LZSSE4_OptimalParseState *state =
-            LZSSE4_MakeOptimalParseState(uncompressed_data_size);
-        if (result = state) {
-          compressed_bytes = LZSSE4_CompressOptimalParse(
-              state, uncompressed_data, uncompressed_data_size, compressed_data,
-              *compressed_data_size, options_.GetCompressionLevel());
-          LZSSE4_FreeOptimalParseState(state);
-        }
-        break;
+    uint8_t number_threads = options_.GetNumberThreads();
+    char *output = compressed_data + 1;
+    uint64_t output_size = *compressed_data_size - 1;
+    if (number_threads == 1) {
+      compressed_data[0] = kSingleBlock;
+      if (result = GetStates(1, uncompressed_data_size)) {
+        compressed_bytes =
+            CompressBlock(states_[0], uncompressed_data,
+                          uncompressed_data_size, output, output_size);
       }
-      case 2: {
-        LZSSE8_OptimalParseState *state =
-            LZSSE8_MakeOptimalParseState(uncompressed_data_size);
-        if (result = state) {
-          compressed_bytes = LZSSE8_CompressOptimalParse(
-              state, uncompressed_data, uncompressed_data_size, compressed_data,
-              *compressed_data_size, options_.GetCompressionLevel());
-          LZSSE8_FreeOptimalParseState(state);
+    } else {
+      // Block format: uncompressed size, block size and the compressed size
+      // of every block, followed by the blocks
+      compressed_data[0] = kBlocks;
+      uint64_t block_size =
+          (uncompressed_data_size + number_threads - 1) / number_threads;
+      if (block_size < (1 << 16)) block_size = 1 << 16;
+      uint64_t number_of_blocks =
+          (uncompressed_data_size + block_size - 1) / block_size;
+      uint64_t header_size = (2 + number_of_blocks) * sizeof(uint64_t);
+      if (header_size < output_size && number_of_blocks &&
+          (result = GetStates(number_threads, block_size))) {
+        // The header is copied at the end, the output may not be aligned
+        std::vector<uint64_t> blocks_size(number_of_blocks);
+        // Every block is compressed into its own slice of the output and
+        // then moved next to the previous one
+        uint64_t slice_size = (output_size - header_size) / number_of_blocks;
+        ParallelFor(number_of_blocks, number_threads,
+                    [&](const uint64_t &block) {
+                      uint64_t offset = block * block_size;
+                      uint64_t size = (block_size < uncompressed_data_size -
+                                                        offset)
+                                          ? block_size
+                                          : uncompressed_data_size - offset;
+                      blocks_size[block] = CompressBlock(
+                          states_[block % number_threads],
+                          uncompressed_data + offset, size,
+                          output + header_size + block * slice_size,
+                          slice_size);
+                    });
+        const uint64_t header[2] = {uncompressed_data_size, block_size};
+        memcpy(output, header, sizeof(header));
+        memcpy(output + sizeof(header), blocks_size.data(),
+               number_of_blocks * sizeof(uint64_t));
+        compressed_bytes = header_size;
+        for (uint64_t block = 0; result && block < number_of_blocks;
+             ++block) {
+          if (result = blocks_size[block]) {
+            memmove(output + compressed_bytes,
+                    output + header_size + block * slice_size,
+                    blocks_size[block]);
+            compressed_bytes += blocks_size[block];
+          }
         }
-        break;
       }
-      default:
-        break;
     }
-    if (result && compressed_bytes == 0 ||
-        compressed_bytes > *compressed_data_size) {
+    if (!result || compressed_bytes == 0 || compressed_bytes > output_size) {
       std::cout << "ERROR: lzsse error when compress data" << std::endl;
       result = false;
     } else {
-      *compressed_data_size = compressed_bytes;
+      *compressed_data_size = compressed_bytes + 1;
     }
   }
   return result;
@@ -87,27 +233,59 @@ bool LzsseLibrary::Decompress(const char *const compressed_data,
                               const uint64_t &compressed_data_size,
                               char *decompressed_data,
                               uint64_t *decompressed_data_size) {
-  bool result{initialized_decompressor_};
+  bool result{initialized_decompressor_ && compressed_data_size > 1};
   if (result) {
     uint64_t decompressed_bytes{0};
-    switch (options_.GetMode()) {
-      case 0:
-        decompressed_bytes =
-            LZSSE2_Decompress(compressed_data, compressed_data_size,
-                              decompressed_data, *decompressed_data_size);
-        break;
-      case 1:
-        decompressed_bytes =
-            LZSSE4_Decompress(compressed_data, compressed_data_size,
-                              decompressed_data, *decompressed_data_size);
-        break;
-      case 2:
-        decompressed_bytes =
-            LZSSE8_Decompress(compressed_data, compressed_data_size,
-                              decompressed_data, *decompressed_data_size);
-        break;
-      default:
-        break;
+    // The thread count only sets how many blocks are decoded at once
+    uint8_t number_threads = options_.GetNumberThreads();
+    const char *const input = compressed_data + 1;
+    uint64_t input_size = compressed_data_size - 1;
+    if (compressed_data[0] == kSingleBlock) {
+      decompressed_bytes = DecompressBlock(input, input_size, decompressed_data,
+                                           *decompressed_data_size);
+    } else if (compressed_data[0] == kBlocks &&
+               input_size > 2 * sizeof(uint64_t)) {
+      uint64_t header[2];
+      memcpy(header, input, sizeof(header));
+      uint64_t uncompressed_data_size = header[0];
+      uint64_t block_size = header[1];
+      uint64_t number_of_blocks =
+          (block_size) ? (uncompressed_data_size + block_size - 1) / block_size
+                       : 0;
+      uint64_t header_size = (2 + number_of_blocks) * sizeof(uint64_t);
+      if (number_of_blocks && number_of_blocks < input_size &&
+          header_size <= input_size &&
+          uncompressed_data_size <= *decompressed_data_size) {
+        // The offset of every block is known before decoding any of them
+        std::vector<uint64_t> blocks_size(number_of_blocks);
+        memcpy(blocks_size.data(), input + sizeof(header),
+               number_of_blocks * sizeof(uint64_t));
+        std::vector<uint64_t> offsets(number_of_blocks);
+        uint64_t offset = header_size;
+        for (uint64_t block = 0;
+             offset <= input_size && block < number_of_blocks; ++block) {
+          offsets[block] = offset;
+          offset = (blocks_size[block] <= input_size - offset)
+                       ? offset + blocks_size[block]
+                       : input_size + 1;
+        }
+        if (offset <= input_size) {
+          std::atomic<bool> error{false};
+          ParallelFor(
+              number_of_blocks, number_threads, [&](const uint64_t &block) {
+                uint64_t position = block * block_size;
+                uint64_t size = (block_size < uncompressed_data_size - position)
+                                    ? block_size
+                                    : uncompressed_data_size - position;
+                if (DecompressBlock(input + offsets[block], blocks_size[block],
+                                    decompressed_data + position,
+                                    size) != size) {
+                  error = true;
+                }
+              });
+          if (!error) decompressed_bytes = uncompressed_data_size;
+        }
+      }
     }
     if (decompressed_bytes == 0 ||
         decompressed_bytes > *decompressed_data_size) {
@@ -156,6 +334,21 @@ bool LzsseLibrary::GetModeInformation(
   return true;
 }
 
+bool LzsseLibrary::GetNumberThreadsInformation(
+    std::vector<std::string> *number_threads_information,
+    uint8_t *minimum_threads, uint8_t *maximum_threads) {
+  if (minimum_threads) *minimum_threads = 1;
+  if (maximum_threads) *maximum_threads = 8;
+  if (number_threads_information) {
+    number_threads_information->clear();
+    number_threads_information->push_back("Available values [1-8]");
+    number_threads_information->push_back(
+        "Values higher than 1 compress with the block format");
+    number_threads_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
 std::string LzsseLibrary::GetModeName(const uint8_t &mode) {
   std::string result = "ERROR";
   if (mode < number_of_modes_) {
@@ -170,6 +363,10 @@ LzsseLibrary::LzsseLibrary() {
   modes_[0] = "LZSSE2";
   modes_[1] = "LZSSE4";
   modes_[2] = "LZSSE8";
+  states_size_ = 0;
 }
 
-LzsseLibrary::~LzsseLibrary() { delete[] modes_; }
+LzsseLibrary::~LzsseLibrary() {
+  FreeStates();
+  delete[] modes_;
+}
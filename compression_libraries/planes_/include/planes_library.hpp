@@ -0,0 +1,94 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_library.hpp>
+#include <cpu_options.hpp>
+
+class PlanesLibrary : public CpuCompressionLibrary {
+ private:
+  uint8_t number_of_modes_;
+  std::string *modes_;
+  CpuCompressionLibrary *plane_library_[2];
+  uint8_t plane_mode_[2];
+  std::vector<char> plane_[2];
+
+  bool CreatePlaneLibrary(const uint8_t &plane,
+                          const std::string &plane_library_name);
+
+  CpuOptions GetPlaneOptions(const CpuOptions &options, const uint8_t &plane);
+
+  uint8_t GetElementSize(const uint8_t &mode);
+
+  void Split(const uint8_t &mode, const uint8_t *data,
+             const uint64_t &number_of_elements, uint8_t *exponents,
+             uint8_t *mantissas);
+
+  void Merge(const uint8_t &mode, const uint8_t *exponents,
+             const uint8_t *mantissas, const uint64_t &number_of_elements,
+             uint8_t *data);
+
+  bool CompressPlane(const uint8_t &plane, const char *const plane_data,
+                     const uint64_t &plane_size, char *compressed_data,
+                     uint64_t *compressed_data_size);
+
+  bool DecompressPlane(const uint8_t &plane, const char *const compressed_data,
+                       const uint64_t &compressed_data_size,
+                       const uint64_t &plane_size, const char **plane_data);
+
+ public:
+  bool CheckOptions(CpuOptions *options, const bool &compressor);
+
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size);
+
+  bool Compress(const char *const uncompressed_data,
+                const uint64_t &uncompressed_data_size, char *compressed_data,
+                uint64_t *compressed_data_size);
+
+  void GetDecompressedDataSize(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               uint64_t *decompressed_data_size);
+
+  bool Decompress(const char *const compressed_data,
+                  const uint64_t &compressed_data_size, char *decompressed_data,
+                  uint64_t *decompressed_data_size);
+
+  void GetTitle();
+
+  bool GetModeInformation(std::vector<std::string> *mode_information = nullptr,
+                          uint8_t *minimum_mode = nullptr,
+                          uint8_t *maximum_mode = nullptr,
+                          const uint8_t &compression_level = 0);
+
+  std::string GetModeName(const uint8_t &mode);
+
+  // The libraries of the planes, as in "planes(fse:1,lz4)". An empty name
+  // stores the plane raw (e.g., "planes(fse:1,)")
+  bool SetArguments(const std::string &arguments);
+
+  void Reset();
+
+  // Every plane is compressed by the given library, written as "name" or
+  // "name:mode" (e.g., "fse:1"), or stored raw if the name is empty
+  PlanesLibrary();
+  PlanesLibrary(const std::string &exponent_library_name,
+                const std::string &mantissa_library_name);
+  ~PlanesLibrary();
+};
@@ -0,0 +1,554 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_libraries.hpp>
+#include <cpu_options.hpp>
+#include <planes_library.hpp>
+
+// Format: mode (1 byte), uncompressed size and stored size of both planes,
+// followed by the exponent plane and the mantissa plane. A plane is raw when
+// its stored size is the same as its size.
+// Every element is rotated one bit to the left, so the sign goes to the
+// mantissa plane and the exponent plane keeps the 8 bits of the BF16 and FP32
+// exponents (for FP16, the 5 bits of the exponent and 3 bits of the mantissa).
+// The bytes that do not fill an element are at the end of the mantissa plane
+static const uint64_t kHeaderSize = 1 + 3 * sizeof(uint64_t);
+
+static inline uint16_t RotateLeft(const uint16_t &value) {
+  return static_cast<uint16_t>((value << 1) | (value >> 15));
+}
+
+static inline uint16_t RotateRight(const uint16_t &value) {
+  return static_cast<uint16_t>((value >> 1) | (value << 15));
+}
+
+static inline uint32_t RotateLeft(const uint32_t &value) {
+  return (value << 1) | (value >> 31);
+}
+
+static inline uint32_t RotateRight(const uint32_t &value) {
+  return (value >> 1) | (value << 31);
+}
+
+#if defined(__SSE2__)
+static inline __m128i Load(const uint8_t *data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+// Takes the byte at the shift position of 16 elements of 32 bits
+static inline __m128i PackBytes(const __m128i *x, const int &shift) {
+  const __m128i mask = _mm_set1_epi32(0xFF);
+  const __m128i count = _mm_cvtsi32_si128(shift);
+  __m128i y[4];
+  for (int i = 0; i < 4; ++i) {
+    y[i] = _mm_and_si128(_mm_srl_epi32(x[i], count), mask);
+  }
+  return _mm_packus_epi16(_mm_packs_epi32(y[0], y[1]),
+                          _mm_packs_epi32(y[2], y[3]));
+}
+
+static inline __m128i RotateRight32(const __m128i &x) {
+  return _mm_or_si128(_mm_srli_epi32(x, 1), _mm_slli_epi32(x, 31));
+}
+#endif
+
+uint8_t PlanesLibrary::GetElementSize(const uint8_t &mode) {
+  return (mode == 0) ? 2 : 4;
+}
+
+void PlanesLibrary::Split(const uint8_t &mode, const uint8_t *data,
+                          const uint64_t &number_of_elements,
+                          uint8_t *exponents, uint8_t *mantissas) {
+  uint64_t i{0};
+  if (mode == 0) {
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi16(0xFF);
+    for (; i + 16 <= number_of_elements; i += 16) {
+      __m128i a = Load(data);
+      __m128i b = Load(data + 16);
+      a = _mm_or_si128(_mm_slli_epi16(a, 1), _mm_srli_epi16(a, 15));
+      b = _mm_or_si128(_mm_slli_epi16(b, 1), _mm_srli_epi16(b, 15));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(exponents + i),
+          _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(mantissas + i),
+          _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+      data += 32;
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= number_of_elements; i += 16) {
+      uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t *>(data));
+      uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t *>(data + 16));
+      a = vsliq_n_u16(vshrq_n_u16(a, 15), a, 1);
+      b = vsliq_n_u16(vshrq_n_u16(b, 15), b, 1);
+      uint8x16x2_t bytes =
+          vuzpq_u8(vreinterpretq_u8_u16(a), vreinterpretq_u8_u16(b));
+      vst1q_u8(mantissas + i, bytes.val[0]);
+      vst1q_u8(exponents + i, bytes.val[1]);
+      data += 32;
+    }
+#endif
+    for (; i < number_of_elements; ++i, data += 2) {
+      uint16_t element;
+      memcpy(&element, data, sizeof(element));
+      element = RotateLeft(element);
+      exponents[i] = static_cast<uint8_t>(element >> 8);
+      mantissas[i] = static_cast<uint8_t>(element);
+    }
+  } else {
+    // The three bytes of the mantissas are kept in three planes
+    uint8_t *mantissas_1 = mantissas + number_of_elements;
+    uint8_t *mantissas_0 = mantissas_1 + number_of_elements;
+#if defined(__SSE2__)
+    for (; i + 16 <= number_of_elements; i += 16) {
+      __m128i x[4];
+      for (int j = 0; j < 4; ++j) {
+        x[j] = Load(data + 16 * j);
+        x[j] = _mm_or_si128(_mm_slli_epi32(x[j], 1), _mm_srli_epi32(x[j], 31));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(exponents + i),
+                       PackBytes(x, 24));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(mantissas + i),
+                       PackBytes(x, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(mantissas_1 + i),
+                       PackBytes(x, 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(mantissas_0 + i),
+                       PackBytes(x, 0));
+      data += 64;
+    }
+#endif
+    for (; i < number_of_elements; ++i, data += 4) {
+      uint32_t element;
+      memcpy(&element, data, sizeof(element));
+      element = RotateLeft(element);
+      exponents[i] = static_cast<uint8_t>(element >> 24);
+      mantissas[i] = static_cast<uint8_t>(element >> 16);
+      mantissas_1[i] = static_cast<uint8_t>(element >> 8);
+      mantissas_0[i] = static_cast<uint8_t>(element);
+    }
+  }
+}
+
+void PlanesLibrary::Merge(const uint8_t &mode, const uint8_t *exponents,
+                          const uint8_t *mantissas,
+                          const uint64_t &number_of_elements, uint8_t *data) {
+  uint64_t i{0};
+  if (mode == 0) {
+#if defined(__SSE2__)
+    for (; i + 16 <= number_of_elements; i += 16) {
+      __m128i e = Load(exponents + i);
+      __m128i m = Load(mantissas + i);
+      __m128i a = _mm_unpacklo_epi8(m, e);
+      __m128i b = _mm_unpackhi_epi8(m, e);
+      a = _mm_or_si128(_mm_srli_epi16(a, 1), _mm_slli_epi16(a, 15));
+      b = _mm_or_si128(_mm_srli_epi16(b, 1), _mm_slli_epi16(b, 15));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(data), a);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(data + 16), b);
+      data += 32;
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= number_of_elements; i += 16) {
+      uint8x16x2_t bytes = vzipq_u8(vld1q_u8(mantissas + i),
+                                    vld1q_u8(exponents + i));
+      uint16x8_t a = vreinterpretq_u16_u8(bytes.val[0]);
+      uint16x8_t b = vreinterpretq_u16_u8(bytes.val[1]);
+      a = vsriq_n_u16(vshlq_n_u16(a, 15), a, 1);
+      b = vsriq_n_u16(vshlq_n_u16(b, 15), b, 1);
+      vst1q_u16(reinterpret_cast<uint16_t *>(data), a);
+      vst1q_u16(reinterpret_cast<uint16_t *>(data + 16), b);
+      data += 32;
+    }
+#endif
+    for (; i < number_of_elements; ++i, data += 2) {
+      uint16_t element = RotateRight(static_cast<uint16_t>(
+          (static_cast<uint16_t>(exponents[i]) << 8) | mantissas[i]));
+      memcpy(data, &element, sizeof(element));
+    }
+  } else {
+    const uint8_t *mantissas_1 = mantissas + number_of_elements;
+    const uint8_t *mantissas_0 = mantissas_1 + number_of_elements;
+#if defined(__SSE2__)
+    for (; i + 16 <= number_of_elements; i += 16) {
+      __m128i e = Load(exponents + i);
+      __m128i m2 = Load(mantissas + i);
+      __m128i m1 = Load(mantissas_1 + i);
+      __m128i m0 = Load(mantissas_0 + i);
+      __m128i low = _mm_unpacklo_epi8(m0, m1);
+      __m128i high = _mm_unpacklo_epi8(m2, e);
+      __m128i *output = reinterpret_cast<__m128i *>(data);
+      _mm_storeu_si128(output, RotateRight32(_mm_unpacklo_epi16(low, high)));
+      _mm_storeu_si128(output + 1,
+                       RotateRight32(_mm_unpackhi_epi16(low, high)));
+      low = _mm_unpackhi_epi8(m0, m1);
+      high = _mm_unpackhi_epi8(m2, e);
+      _mm_storeu_si128(output + 2,
+                       RotateRight32(_mm_unpacklo_epi16(low, high)));
+      _mm_storeu_si128(output + 3,
+                       RotateRight32(_mm_unpackhi_epi16(low, high)));
+      data += 64;
+    }
+#endif
+    for (; i < number_of_elements; ++i, data += 4) {
+      uint32_t element = RotateRight(
+          (static_cast<uint32_t>(exponents[i]) << 24) |
+          (static_cast<uint32_t>(mantissas[i]) << 16) |
+          (static_cast<uint32_t>(mantissas_1[i]) << 8) | mantissas_0[i]);
+      memcpy(data, &element, sizeof(element));
+    }
+  }
+}
+
+bool PlanesLibrary::CreatePlaneLibrary(const uint8_t &plane,
+                                       const std::string &plane_library_name) {
+  delete plane_library_[plane];
+  plane_library_[plane] = nullptr;
+  plane_mode_[plane] = 0;
+  if (plane_library_name.empty()) return true;
+  std::string name = plane_library_name;
+  uint16_t library_id;
+  size_t separator = name.find(':');
+  if (separator != std::string::npos) {
+    plane_mode_[plane] = 1 + static_cast<uint8_t>(
+                                 atoi(name.substr(separator + 1).c_str()));
+    name = name.substr(0, separator);
+  }
+  bool result = CpuCompressionLibraries().GetLibraryId(name, &library_id);
+  if (result) {
+    plane_library_[plane] =
+        CpuCompressionLibraries().GetCompressionLibrary(library_id);
+  }
+  return result;
+}
+
+CpuOptions PlanesLibrary::GetPlaneOptions(const CpuOptions &options,
+                                          const uint8_t &plane) {
+  // The mode belongs to planes, the rest of options are for the library of
+  // every plane
+  CpuOptions plane_options;
+  if (options.CompressionLevelIsSet()) {
+    plane_options.SetCompressionLevel(options.GetCompressionLevel());
+  }
+  if (options.WindowSizeIsSet()) {
+    plane_options.SetWindowSize(options.GetWindowSize());
+  }
+  if (options.NumberThreadsIsSet()) {
+    plane_options.SetNumberThreads(options.GetNumberThreads());
+  }
+  if (plane_mode_[plane]) plane_options.SetMode(plane_mode_[plane] - 1);
+  return plane_options;
+}
+
+bool PlanesLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
+  bool result{true};
+  // The mode is taken from the data type when there is no other mode. It is
+  // stored in the compressed data, so the decompressor does not use it
+  if (compressor) {
+    if (!options->ModeIsSet() && options->DataTypeIsSet() &&
+        options->GetDataType() == kCpuFloat32) {
+      options->SetMode(1);
+    }
+    result = CpuCompressionLibrary::CheckMode("planes", options, 0, 1);
+  }
+  return result;
+}
+
+bool PlanesLibrary::SetOptionsCompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsCompressor(options)};
+  for (uint8_t plane = 0; result && plane < 2; ++plane) {
+    if (plane_library_[plane]) {
+      CpuOptions plane_options = GetPlaneOptions(*options, plane);
+      initialized_compressor_ = result =
+          plane_library_[plane]->SetOptionsCompressor(&plane_options);
+    }
+  }
+  return result;
+}
+
+bool PlanesLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsDecompressor(options)};
+  for (uint8_t plane = 0; result && plane < 2; ++plane) {
+    if (plane_library_[plane]) {
+      CpuOptions plane_options = GetPlaneOptions(*options, plane);
+      initialized_decompressor_ = result =
+          plane_library_[plane]->SetOptionsDecompressor(&plane_options);
+    }
+  }
+  return result;
+}
+
+void PlanesLibrary::GetCompressedDataSize(
+    const char *const uncompressed_data, const uint64_t &uncompressed_data_size,
+    uint64_t *compressed_data_size) {
+  const uint64_t number_of_elements =
+      uncompressed_data_size / GetElementSize(options_.GetMode());
+  const uint64_t plane_size[2] = {
+      number_of_elements, uncompressed_data_size - number_of_elements};
+  *compressed_data_size = kHeaderSize;
+  for (uint8_t plane = 0; plane < 2; ++plane) {
+    uint64_t size = plane_size[plane];
+    if (plane_library_[plane]) {
+      plane_library_[plane]->GetCompressedDataSize(nullptr, plane_size[plane],
+                                                   &size);
+      if (size < plane_size[plane]) size = plane_size[plane];
+    }
+    *compressed_data_size += size;
+  }
+}
+
+bool PlanesLibrary::CompressPlane(const uint8_t &plane,
+                                  const char *const plane_data,
+                                  const uint64_t &plane_size,
+                                  char *compressed_data,
+                                  uint64_t *compressed_data_size) {
+  uint64_t size{0};
+  if (plane_library_[plane] && plane_size) {
+    // The plane is compressed only if the worst case fits in the output. As
+    // in a chain, the worst case is asked without the data
+    plane_library_[plane]->GetCompressedDataSize(nullptr, plane_size, &size);
+    if (size <= *compressed_data_size &&
+        !plane_library_[plane]->Compress(plane_data, plane_size,
+                                         compressed_data, &size)) {
+      size = 0;
+    }
+  }
+  if (size == 0 || size >= plane_size) {
+    // Raw plane
+    size = plane_size;
+    if (size > *compressed_data_size) return false;
+    if (size) memcpy(compressed_data, plane_data, size);
+  }
+  *compressed_data_size = size;
+  return true;
+}
+
+bool PlanesLibrary::Compress(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             char *compressed_data,
+                             uint64_t *compressed_data_size) {
+  bool result{initialized_compressor_ && kHeaderSize <= *compressed_data_size};
+  if (result) {
+    const uint8_t mode = options_.GetMode();
+    const uint64_t number_of_elements =
+        uncompressed_data_size / GetElementSize(mode);
+    const uint64_t elements_size = number_of_elements * GetElementSize(mode);
+    const uint64_t plane_size[2] = {
+        number_of_elements, uncompressed_data_size - number_of_elements};
+    for (uint8_t plane = 0; plane < 2; ++plane) {
+      if (plane_[plane].size() < plane_size[plane]) {
+        plane_[plane].resize(plane_size[plane]);
+      }
+    }
+    uint8_t *exponents = reinterpret_cast<uint8_t *>(plane_[0].data());
+    uint8_t *mantissas = reinterpret_cast<uint8_t *>(plane_[1].data());
+    Split(mode, reinterpret_cast<const uint8_t *>(uncompressed_data),
+          number_of_elements, exponents, mantissas);
+    if (elements_size < uncompressed_data_size) {
+      memcpy(mantissas + elements_size - number_of_elements,
+             uncompressed_data + elements_size,
+             uncompressed_data_size - elements_size);
+    }
+    // The output can be inside a chain, so the header is copied at the end
+    uint64_t header[3] = {uncompressed_data_size, 0, 0};
+    uint64_t compressed_bytes{kHeaderSize};
+    for (uint8_t plane = 0; result && plane < 2; ++plane) {
+      uint64_t size = *compressed_data_size - compressed_bytes;
+      result = CompressPlane(plane, plane_[plane].data(), plane_size[plane],
+                             compressed_data + compressed_bytes, &size);
+      header[plane + 1] = size;
+      compressed_bytes += size;
+    }
+    if (!result) {
+      std::cout << "ERROR: planes error when compress data" << std::endl;
+    } else {
+      // The decompressor takes the mode from the data
+      compressed_data[0] = static_cast<char>(mode);
+      memcpy(compressed_data + 1, header, sizeof(header));
+      *compressed_data_size = compressed_bytes;
+    }
+  }
+  return result;
+}
+
+void PlanesLibrary::GetDecompressedDataSize(
+    const char *const compressed_data, const uint64_t &compressed_data_size,
+    uint64_t *decompressed_data_size) {
+  if (compressed_data_size >= kHeaderSize) {
+    memcpy(decompressed_data_size, compressed_data + 1, sizeof(uint64_t));
+  } else {
+    *decompressed_data_size = 0;
+  }
+}
+
+bool PlanesLibrary::DecompressPlane(const uint8_t &plane,
+                                    const char *const compressed_data,
+                                    const uint64_t &compressed_data_size,
+                                    const uint64_t &plane_size,
+                                    const char **plane_data) {
+  bool result{true};
+  if (compressed_data_size == plane_size) {
+    // Raw plane
+    *plane_data = compressed_data;
+  } else {
+    if (plane_[plane].size() < plane_size) plane_[plane].resize(plane_size);
+    uint64_t size = plane_size;
+    result = plane_library_[plane] &&
+             plane_library_[plane]->Decompress(compressed_data,
+                                               compressed_data_size,
+                                               plane_[plane].data(), &size) &&
+             size == plane_size;
+    *plane_data = plane_[plane].data();
+  }
+  return result;
+}
+
+bool PlanesLibrary::Decompress(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               char *decompressed_data,
+                               uint64_t *decompressed_data_size) {
+  bool result{initialized_decompressor_ &&
+              compressed_data_size >= kHeaderSize};
+  if (result) {
+    const uint8_t mode = static_cast<uint8_t>(compressed_data[0]);
+    uint64_t header[3];
+    memcpy(header, compressed_data + 1, sizeof(header));
+    const uint64_t uncompressed_data_size = header[0];
+    const uint64_t number_of_elements =
+        uncompressed_data_size / GetElementSize(mode);
+    const uint64_t elements_size = number_of_elements * GetElementSize(mode);
+    const uint64_t plane_size[2] = {
+        number_of_elements, uncompressed_data_size - number_of_elements};
+    const char *plane_data[2] = {nullptr, nullptr};
+    uint64_t compressed_bytes{kHeaderSize};
+    result = mode <= 1 && uncompressed_data_size <= *decompressed_data_size;
+    for (uint8_t plane = 0; result && plane < 2; ++plane) {
+      result = header[plane + 1] <= compressed_data_size - compressed_bytes &&
+               DecompressPlane(plane, compressed_data + compressed_bytes,
+                               header[plane + 1], plane_size[plane],
+                               &plane_data[plane]);
+      compressed_bytes += header[plane + 1];
+    }
+    if (result) {
+      const uint8_t *mantissas =
+          reinterpret_cast<const uint8_t *>(plane_data[1]);
+      Merge(mode, reinterpret_cast<const uint8_t *>(plane_data[0]), mantissas,
+            number_of_elements, reinterpret_cast<uint8_t *>(decompressed_data));
+      if (elements_size < uncompressed_data_size) {
+        memcpy(decompressed_data + elements_size,
+               mantissas + elements_size - number_of_elements,
+               uncompressed_data_size - elements_size);
+      }
+      *decompressed_data_size = uncompressed_data_size;
+    } else {
+      std::cout << "ERROR: planes error when decompress data" << std::endl;
+    }
+  }
+  return result;
+}
+
+void PlanesLibrary::GetTitle() {
+  CpuCompressionLibrary::GetTitle(
+      "planes",
+      "Splits floating point data in exponent and mantissa planes, which are "
+      "compressed separately");
+}
+
+bool PlanesLibrary::GetModeInformation(
+    std::vector<std::string> *mode_information, uint8_t *minimum_mode,
+    uint8_t *maximum_mode, const uint8_t &compression_level) {
+  if (minimum_mode) *minimum_mode = 0;
+  if (maximum_mode) *maximum_mode = 1;
+  if (mode_information) {
+    mode_information->clear();
+    mode_information->push_back("Available values [0-1]");
+    mode_information->push_back("0: " + modes_[0] + " elements of 2 bytes");
+    mode_information->push_back("1: " + modes_[1] + " elements of 4 bytes");
+    mode_information->push_back("[compression]");
+  }
+  return true;
+}
+
+std::string PlanesLibrary::GetModeName(const uint8_t &mode) {
+  std::string result = "ERROR";
+  if (mode < number_of_modes_) {
+    result = modes_[mode];
+  }
+  return result;
+}
+
+// Without arguments, the default libraries are kept
+bool PlanesLibrary::SetArguments(const std::string &arguments) {
+  if (arguments.empty()) return true;
+  size_t separator = arguments.find(',');
+  bool result{separator != std::string::npos &&
+              arguments.find(',', separator + 1) == std::string::npos &&
+              CreatePlaneLibrary(0, arguments.substr(0, separator)) &&
+              CreatePlaneLibrary(1, arguments.substr(separator + 1))};
+  if (result) {
+    initialized_compressor_ = false;
+    initialized_decompressor_ = false;
+  } else {
+    std::cout << "ERROR: The compression libraries of the planes must be "
+                 "given as \"exponent,mantissa\""
+              << std::endl;
+  }
+  return result;
+}
+
+void PlanesLibrary::Reset() {
+  for (auto &plane_library : plane_library_) {
+    if (plane_library) plane_library->Reset();
+  }
+  CpuCompressionLibrary::Reset();
+}
+
+PlanesLibrary::PlanesLibrary() {
+  number_of_modes_ = 2;
+  modes_ = new std::string[number_of_modes_];
+  modes_[0] = "BF16/FP16";
+  modes_[1] = "FP32";
+  plane_library_[0] = plane_library_[1] = nullptr;
+  // The exponents are skewed, so they are compressed with Huff0 when it is
+  // available. The mantissas are close to random and they are stored raw
+  uint16_t library_id;
+  CreatePlaneLibrary(0, CpuCompressionLibraries().GetLibraryId("fse",
+                                                               &library_id)
+                            ? "fse:1"
+                            : "");
+  CreatePlaneLibrary(1, "");
+}
+
+PlanesLibrary::PlanesLibrary(const std::string &exponent_library_name,
+                             const std::string &mantissa_library_name) {
+  number_of_modes_ = 2;
+  modes_ = new std::string[number_of_modes_];
+  modes_[0] = "BF16/FP16";
+  modes_[1] = "FP32";
+  plane_library_[0] = plane_library_[1] = nullptr;
+  if (!CreatePlaneLibrary(0, exponent_library_name) ||
+      !CreatePlaneLibrary(1, mantissa_library_name)) {
+    std::cout << "ERROR: The compression library of the planes does not exist"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+PlanesLibrary::~PlanesLibrary() {
+  delete plane_library_[0];
+  delete plane_library_[1];
+  delete[] modes_;
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <quicklz.h>
+
 #include <iostream>
 #include <string>
 #include <vector>
@@ -17,7 +19,22 @@
 #include <cpu_options.hpp>
 
 class QuicklzLibrary : public CpuCompressionLibrary {
+ private:
+  uint8_t number_of_modes_;
+  std::string *modes_;
+  // Kept between calls, the session ones also keep the message history
+  qlz_state_compress *state_compress_;
+  qlz_state_decompress *state_decompress_;
+  char *session_state_compress_;
+  char *session_state_decompress_;
+
  public:
+  bool CheckOptions(CpuOptions *options, const bool &compressor);
+
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
   void GetCompressedDataSize(const char *const uncompressed_data,
                              const uint64_t &uncompressed_data_size,
                              uint64_t *compressed_data_size);
@@ -36,6 +53,15 @@ class QuicklzLibrary : public CpuCompressionLibrary {
 
   void GetTitle();
 
+  bool GetModeInformation(std::vector<std::string> *mode_information = nullptr,
+                          uint8_t *minimum_mode = nullptr,
+                          uint8_t *maximum_mode = nullptr,
+                          const uint8_t &compression_level = 0);
+
+  std::string GetModeName(const uint8_t &mode);
+
+  bool IsStateless();
+
   QuicklzLibrary();
   ~QuicklzLibrary();
 };
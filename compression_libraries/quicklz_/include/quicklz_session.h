@@ -0,0 +1,31 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* QuickLZ built with a streaming buffer. States are opaque and must be zeroed
+ * before the first call of a session */
+size_t qlz_session_state_compress_size(void);
+
+size_t qlz_session_state_decompress_size(void);
+
+size_t qlz_session_compress(const void *source, char *destination, size_t size,
+                            void *state);
+
+size_t qlz_session_decompress(const char *source, void *destination,
+                              void *state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,10 +7,41 @@
  */
 
 #include <quicklz.h>
+#include <string.h>
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
 #include <quicklz_library.hpp>
+#include <quicklz_session.h>
+
+bool QuicklzLibrary::CheckOptions(CpuOptions *options,
+                                  const bool &compressor) {
+  return CpuCompressionLibrary::CheckMode("quicklz", options, 0, 1);
+}
+
+bool QuicklzLibrary::SetOptionsCompressor(CpuOptions *options) {
+  bool result = CpuCompressionLibrary::SetOptionsCompressor(options);
+  if (result && options_.GetMode() == 1) {
+    // A new session starts with an empty history
+    if (!session_state_compress_) {
+      session_state_compress_ = new char[qlz_session_state_compress_size()];
+    }
+    memset(session_state_compress_, 0, qlz_session_state_compress_size());
+  }
+  return result;
+}
+
+bool QuicklzLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  bool result = CpuCompressionLibrary::SetOptionsDecompressor(options);
+  if (result && options_.GetMode() == 1) {
+    if (!session_state_decompress_) {
+      session_state_decompress_ =
+          new char[qlz_session_state_decompress_size()];
+    }
+    memset(session_state_decompress_, 0, qlz_session_state_decompress_size());
+  }
+  return result;
+}
 
 void QuicklzLibrary::GetCompressedDataSize(
     const char *const uncompressed_data, const uint64_t &uncompressed_data_size,
@@ -29,9 +60,15 @@ bool QuicklzLibrary::Compress(const char *const uncompressed_data,
                               uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    qlz_state_compress state;
-    uint64_t final_size = qlz_compress(uncompressed_data, compressed_data,
-                                       uncompressed_data_size, &state);
+    uint64_t final_size{0};
+    if (options_.GetMode() == 0) {
+      final_size = qlz_compress(uncompressed_data, compressed_data,
+                                uncompressed_data_size, state_compress_);
+    } else {
+      final_size =
+          qlz_session_compress(uncompressed_data, compressed_data,
+                               uncompressed_data_size, session_state_compress_);
+    }
     if (final_size == 0) {
       std::cout << "ERROR: quicklz error when compress data" << std::endl;
       result = false;
@@ -48,9 +85,14 @@ bool QuicklzLibrary::Decompress(const char *const compressed_data,
                                 uint64_t *decompressed_data_size) {
   bool result{initialized_decompressor_};
   if (result) {
-    qlz_state_decompress state;
-    uint64_t final_size =
-        qlz_decompress(compressed_data, decompressed_data, &state);
+    uint64_t final_size{0};
+    if (options_.GetMode() == 0) {
+      final_size =
+          qlz_decompress(compressed_data, decompressed_data, state_decompress_);
+    } else {
+      final_size = qlz_session_decompress(compressed_data, decompressed_data,
+                                          session_state_decompress_);
+    }
     if (final_size == 0) {
       std::cout << "ERROR: quicklz error when decompress data" << std::endl;
       result = false;
@@ -71,6 +113,50 @@ void QuicklzLibrary::GetTitle() {
   CpuCompressionLibrary::GetTitle("quicklz", "Fast GPL'd compression library.");
 }
 
-QuicklzLibrary::QuicklzLibrary() {}
+bool QuicklzLibrary::GetModeInformation(
+    std::vector<std::string> *mode_information, uint8_t *minimum_mode,
+    uint8_t *maximum_mode, const uint8_t &compression_level) {
+  if (minimum_mode) *minimum_mode = 0;
+  if (maximum_mode) *maximum_mode = 1;
+  if (mode_information) {
+    mode_information->clear();
+    mode_information->push_back("Available values [0-1]");
+    mode_information->push_back("0: " + modes_[0] +
+                                " messages, each one has its own history");
+    mode_information->push_back(
+        "1: " + modes_[1] +
+        " of messages, consecutive messages share the history");
+    mode_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
 
-QuicklzLibrary::~QuicklzLibrary() {}
+std::string QuicklzLibrary::GetModeName(const uint8_t &mode) {
+  std::string result = "ERROR";
+  if (mode < number_of_modes_) {
+    result = modes_[mode];
+  }
+  return result;
+}
+
+// The session mode keeps the history of the previous messages
+bool QuicklzLibrary::IsStateless() { return options_.GetMode() != 1; }
+
+QuicklzLibrary::QuicklzLibrary() {
+  number_of_modes_ = 2;
+  modes_ = new std::string[number_of_modes_];
+  modes_[0] = "Independent";
+  modes_[1] = "Session";
+  state_compress_ = new qlz_state_compress;
+  state_decompress_ = new qlz_state_decompress;
+  session_state_compress_ = nullptr;
+  session_state_decompress_ = nullptr;
+}
+
+QuicklzLibrary::~QuicklzLibrary() {
+  delete[] modes_;
+  delete state_compress_;
+  delete state_decompress_;
+  delete[] session_state_compress_;
+  delete[] session_state_decompress_;
+}
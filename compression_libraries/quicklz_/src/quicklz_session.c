@@ -0,0 +1,46 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+/* QuickLZ settings are compile time only, so the streaming build is a second
+ * copy of quicklz.c with its public symbols renamed */
+#define QLZ_COMPRESSION_LEVEL 1
+#define QLZ_STREAMING_BUFFER 100000
+
+#define qlz_size_decompressed qlz_session_size_decompressed
+#define qlz_size_compressed qlz_session_size_compressed
+#define qlz_size_header qlz_session_size_header
+#define qlz_compress qlz_session_compress_state
+#define qlz_decompress qlz_session_decompress_state
+#define qlz_get_setting qlz_session_get_setting
+#define qlz_state_compress qlz_session_state_compress
+#define qlz_state_decompress qlz_session_state_decompress
+#define qlz_hash_compress qlz_session_hash_compress
+#define qlz_hash_decompress qlz_session_hash_decompress
+
+#include "quicklz.c"
+
+// CPU-SMASH LIBRARIES
+#include "quicklz_session.h"
+
+size_t qlz_session_state_compress_size(void) {
+  return sizeof(qlz_state_compress);
+}
+
+size_t qlz_session_state_decompress_size(void) {
+  return sizeof(qlz_state_decompress);
+}
+
+size_t qlz_session_compress(const void *source, char *destination, size_t size,
+                            void *state) {
+  return qlz_compress(source, destination, size, (qlz_state_compress *)state);
+}
+
+size_t qlz_session_decompress(const char *source, void *destination,
+                              void *state) {
+  return qlz_decompress(source, destination, (qlz_state_decompress *)state);
+}
@@ -16,6 +16,17 @@
 #include <cpu_compression_library.hpp>
 #include <cpu_options.hpp>
 class WflzLibrary : public CpuCompressionLibrary {
+ private:
+  uint8_t number_of_modes_;
+  std::string *modes_;
+  std::vector<uint8_t> work_memory_;
+
+  uint8_t *GetWorkMemory(const uint8_t &number_threads);
+
+  uint64_t CompressChunk(const char *const uncompressed_data,
+                         const uint64_t &uncompressed_data_size,
+                         char *compressed_data, uint8_t *work_memory);
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
@@ -41,6 +52,17 @@ class WflzLibrary : public CpuCompressionLibrary {
       std::vector<std::string> *compression_level_information = nullptr,
       uint8_t *minimum_level = nullptr, uint8_t *maximum_level = nullptr);
 
+  bool GetModeInformation(std::vector<std::string> *mode_information = nullptr,
+                          uint8_t *minimum_mode = nullptr,
+                          uint8_t *maximum_mode = nullptr,
+                          const uint8_t &compression_level = 0);
+
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr);
+
+  std::string GetModeName(const uint8_t &mode);
+
   WflzLibrary();
   ~WflzLibrary();
 };
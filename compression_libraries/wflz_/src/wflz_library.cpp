@@ -6,25 +6,74 @@
  * Universidad Politécnica de Valencia (Spain)
  */
 
+#include <string.h>
 #include <wfLZ.h>
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
 #include <wflz_library.hpp>
 
+// Size of every chunk in the chunked mode. wfLZ matches are at most 64 KB
+// away, so bigger chunks barely improve the compression ratio
+static const uint64_t kChunkSize{1 << 18};
+
+// Size of the header that starts every wfLZ block (signature, compressed and
+// uncompressed sizes). It is not exported by wfLZ.h
+static const uint64_t kWflzHeaderSize{12};
+
 bool WflzLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
   bool result{true};
   if (compressor) {
     result =
         CpuCompressionLibrary::CheckCompressionLevel("wflz", options, 0, 1);
   }
+  if (result) {
+    result = CpuCompressionLibrary::CheckMode("wflz", options, 0, 1);
+  }
+  if (result) {
+    result = CpuCompressionLibrary::CheckNumberThreads("wflz", options, 1, 8);
+  }
   return result;
 }
 
+uint8_t *WflzLibrary::GetWorkMemory(const uint8_t &number_threads) {
+  uint64_t size = number_threads * static_cast<uint64_t>(wfLZ_GetWorkMemSize());
+  if (work_memory_.size() < size) work_memory_.resize(size);
+  return work_memory_.data();
+}
+
+uint64_t WflzLibrary::CompressChunk(const char *const uncompressed_data,
+                                    const uint64_t &uncompressed_data_size,
+                                    char *compressed_data,
+                                    uint8_t *work_memory) {
+  uint64_t bytes{0};
+  if (options_.GetCompressionLevel() == 0) {
+    bytes =
+        wfLZ_Compress(reinterpret_cast<const uint8_t *const>(uncompressed_data),
+                      uncompressed_data_size,
+                      reinterpret_cast<uint8_t *>(compressed_data),
+                      work_memory, 0);
+  } else {
+    bytes = wfLZ_CompressFast(
+        reinterpret_cast<const uint8_t *const>(uncompressed_data),
+        uncompressed_data_size, reinterpret_cast<uint8_t *>(compressed_data),
+        work_memory, 0);
+  }
+  return bytes;
+}
+
 void WflzLibrary::GetCompressedDataSize(const char *const uncompressed_data,
                                         const uint64_t &uncompressed_data_size,
                                         uint64_t *compressed_data_size) {
-  *compressed_data_size = wfLZ_GetMaxCompressedSize(uncompressed_data_size);
+  if (options_.GetMode() == 0) {
+    *compressed_data_size = wfLZ_GetMaxCompressedSize(uncompressed_data_size);
+  } else {
+    uint64_t number_of_chunks =
+        (uncompressed_data_size + kChunkSize - 1) / kChunkSize;
+    *compressed_data_size = (2 + number_of_chunks) * sizeof(uint64_t) +
+                            number_of_chunks *
+                                wfLZ_GetMaxCompressedSize(kChunkSize);
+  }
 }
 
 bool WflzLibrary::Compress(const char *const uncompressed_data,
@@ -33,26 +82,58 @@ bool WflzLibrary::Compress(const char *const uncompressed_data,
                            uint64_t *compressed_data_size) {
   bool result{initialized_compressor_};
   if (result) {
-    uint8_t *work_mememory = new uint8_t[wfLZ_GetWorkMemSize()];
     uint64_t bytes{0};
-    if (options_.GetCompressionLevel() == 0) {
-      bytes = wfLZ_Compress(
-          reinterpret_cast<const uint8_t *const>(uncompressed_data),
-          uncompressed_data_size, reinterpret_cast<uint8_t *>(compressed_data),
-          work_mememory, 0);
+    uint8_t number_threads = options_.GetNumberThreads();
+    if (options_.GetMode() == 0) {
+      bytes = CompressChunk(uncompressed_data, uncompressed_data_size,
+                            compressed_data, GetWorkMemory(1));
     } else {
-      bytes = wfLZ_CompressFast(
-          reinterpret_cast<const uint8_t *const>(uncompressed_data),
-          uncompressed_data_size, reinterpret_cast<uint8_t *>(compressed_data),
-          work_mememory, 0);
+      // Chunked format: uncompressed size, chunk size and the compressed size
+      // of every chunk, followed by the chunks
+      uint64_t number_of_chunks =
+          (uncompressed_data_size + kChunkSize - 1) / kChunkSize;
+      uint64_t header_size = (2 + number_of_chunks) * sizeof(uint64_t);
+      uint64_t slice_size = wfLZ_GetMaxCompressedSize(kChunkSize);
+      // wfLZ does not check the output size, so every slice must fit. Empty
+      // data is only the header
+      if (header_size + number_of_chunks * slice_size <=
+          *compressed_data_size) {
+        // The header is copied at the end, the output may not be aligned
+        std::vector<uint64_t> chunks_size(number_of_chunks);
+        uint8_t *work_memory = GetWorkMemory(number_threads);
+        uint64_t work_memory_size = wfLZ_GetWorkMemSize();
+        ParallelFor(
+            number_of_chunks, number_threads, [&](const uint64_t &chunk) {
+              uint64_t offset = chunk * kChunkSize;
+              uint64_t size = (kChunkSize < uncompressed_data_size - offset)
+                                  ? kChunkSize
+                                  : uncompressed_data_size - offset;
+              chunks_size[chunk] = CompressChunk(
+                  uncompressed_data + offset, size,
+                  compressed_data + header_size + chunk * slice_size,
+                  work_memory + (chunk % number_threads) * work_memory_size);
+            });
+        const uint64_t header[2] = {uncompressed_data_size, kChunkSize};
+        memcpy(compressed_data, header, sizeof(header));
+        if (number_of_chunks) {
+          memcpy(compressed_data + sizeof(header), chunks_size.data(),
+                 number_of_chunks * sizeof(uint64_t));
+        }
+        bytes = header_size;
+        for (uint64_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+          memmove(compressed_data + bytes,
+                  compressed_data + header_size + chunk * slice_size,
+                  chunks_size[chunk]);
+          bytes += chunks_size[chunk];
+        }
+      }
     }
-    if (bytes > *compressed_data_size) {
+    if (bytes == 0 || bytes > *compressed_data_size) {
       std::cout << "ERROR: wflz error when compress data" << std::endl;
       result = false;
     } else {
       *compressed_data_size = bytes;
     }
-    delete[] work_mememory;
   }
   return result;
 }
@@ -60,8 +141,15 @@ bool WflzLibrary::Compress(const char *const uncompressed_data,
 void WflzLibrary::GetDecompressedDataSize(const char *const compressed_data,
                                           const uint64_t &compressed_data_size,
                                           uint64_t *decompressed_data_size) {
-  *decompressed_data_size = wfLZ_GetDecompressedSize(
-      reinterpret_cast<const uint8_t *const>(compressed_data));
+  *decompressed_data_size = 0;
+  if (options_.GetMode() == 0) {
+    if (compressed_data_size >= kWflzHeaderSize) {
+      *decompressed_data_size = wfLZ_GetDecompressedSize(
+          reinterpret_cast<const uint8_t *const>(compressed_data));
+    }
+  } else if (compressed_data_size >= 2 * sizeof(uint64_t)) {
+    memcpy(decompressed_data_size, compressed_data, sizeof(uint64_t));
+  }
 }
 
 bool WflzLibrary::Decompress(const char *const compressed_data,
@@ -72,13 +160,55 @@ bool WflzLibrary::Decompress(const char *const compressed_data,
   if (result) {
     uint64_t bytes{0};
     GetDecompressedDataSize(compressed_data, compressed_data_size, &bytes);
-    if (bytes <= *decompressed_data_size) {
+    result = (bytes <= *decompressed_data_size &&
+              compressed_data_size >= kWflzHeaderSize);
+    if (result && options_.GetMode() == 0) {
       wfLZ_Decompress(reinterpret_cast<const uint8_t *const>(compressed_data),
                       reinterpret_cast<uint8_t *>(decompressed_data));
+    } else if (result) {
+      uint64_t header[2] = {0, 0};
+      result = (compressed_data_size >= sizeof(header));
+      if (result) memcpy(header, compressed_data, sizeof(header));
+      uint64_t chunk_size = header[1];
+      uint64_t number_of_chunks =
+          (chunk_size) ? (bytes + chunk_size - 1) / chunk_size : 0;
+      uint64_t header_size = (2 + number_of_chunks) * sizeof(uint64_t);
+      result = (result && chunk_size && header_size <= compressed_data_size);
+      std::vector<uint64_t> chunks_size(result ? number_of_chunks : 0);
+      if (result && number_of_chunks) {
+        memcpy(chunks_size.data(), compressed_data + sizeof(header),
+               number_of_chunks * sizeof(uint64_t));
+      }
+      // The offset of every chunk is known before decoding any of them
+      std::vector<uint64_t> offsets(result ? number_of_chunks : 0);
+      uint64_t offset = header_size;
+      for (uint64_t chunk = 0; result && chunk < number_of_chunks; ++chunk) {
+        offsets[chunk] = offset;
+        result = (chunks_size[chunk] <= compressed_data_size - offset &&
+                  chunks_size[chunk] >= kWflzHeaderSize);
+        offset += chunks_size[chunk];
+        uint64_t position = chunk * chunk_size;
+        uint64_t size = (chunk_size < bytes - position) ? chunk_size
+                                                        : bytes - position;
+        result = (result &&
+                  wfLZ_GetDecompressedSize(reinterpret_cast<const uint8_t *>(
+                      compressed_data + offsets[chunk])) == size);
+      }
+      if (result && number_of_chunks) {
+        ParallelFor(number_of_chunks, options_.GetNumberThreads(),
+                    [&](const uint64_t &chunk) {
+                      wfLZ_Decompress(reinterpret_cast<const uint8_t *const>(
+                                          compressed_data + offsets[chunk]),
+                                      reinterpret_cast<uint8_t *>(
+                                          decompressed_data +
+                                          chunk * chunk_size));
+                    });
+      }
+    }
+    if (result) {
       *decompressed_data_size = bytes;
     } else {
       std::cout << "ERROR: wflz error when decompress data" << std::endl;
-      result = false;
     }
   }
   return result;
@@ -102,6 +232,49 @@ bool WflzLibrary::GetCompressionLevelInformation(
   return true;
 }
 
-WflzLibrary::WflzLibrary() {}
+bool WflzLibrary::GetModeInformation(
+    std::vector<std::string> *mode_information, uint8_t *minimum_mode,
+    uint8_t *maximum_mode, const uint8_t &compression_level) {
+  if (minimum_mode) *minimum_mode = 0;
+  if (maximum_mode) *maximum_mode = 1;
+  if (mode_information) {
+    mode_information->clear();
+    mode_information->push_back("Available values [0-1]");
+    mode_information->push_back("0: " + modes_[0] + " block");
+    mode_information->push_back(
+        "1: " + modes_[1] + " blocks that can be decompressed in parallel");
+    mode_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
+bool WflzLibrary::GetNumberThreadsInformation(
+    std::vector<std::string> *number_threads_information,
+    uint8_t *minimum_threads, uint8_t *maximum_threads) {
+  if (minimum_threads) *minimum_threads = 1;
+  if (maximum_threads) *maximum_threads = 8;
+  if (number_threads_information) {
+    number_threads_information->clear();
+    number_threads_information->push_back("Available values [1-8]");
+    number_threads_information->push_back("Only used by the chunked mode");
+    number_threads_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
+std::string WflzLibrary::GetModeName(const uint8_t &mode) {
+  std::string result = "ERROR";
+  if (mode < number_of_modes_) {
+    result = modes_[mode];
+  }
+  return result;
+}
+
+WflzLibrary::WflzLibrary() {
+  number_of_modes_ = 2;
+  modes_ = new std::string[number_of_modes_];
+  modes_[0] = "Single";
+  modes_[1] = "Chunked";
+}
 
-WflzLibrary::~WflzLibrary() {}
+WflzLibrary::~WflzLibrary() { delete[] modes_; }
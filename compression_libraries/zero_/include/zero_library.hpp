@@ -0,0 +1,85 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_library.hpp>
+#include <cpu_options.hpp>
+
+class ZeroLibrary : public CpuCompressionLibrary {
+ private:
+  uint8_t number_of_modes_;
+  std::string *modes_;
+  CpuCompressionLibrary *residue_;
+  std::vector<uint8_t> map_;
+  std::vector<char> packed_;
+
+  CpuOptions GetResidueOptions(const CpuOptions &options);
+
+  uint64_t EncodeBitmap(const uint8_t *data, const uint64_t &data_size,
+                        uint8_t *bitmap, uint8_t *packed);
+
+  bool DecodeBitmap(const uint8_t *bitmap, const uint8_t *packed,
+                    const uint64_t &packed_size, uint8_t *data,
+                    const uint64_t &data_size);
+
+  void EncodeRuns(const uint8_t *data, const uint64_t &data_size);
+
+  uint64_t PackRuns(const uint8_t *data, const uint64_t &data_size,
+                    uint8_t *packed);
+
+  bool DecodeRuns(const uint8_t *runs, const uint64_t &runs_size,
+                  const uint8_t *packed, const uint64_t &packed_size,
+                  uint8_t *data, const uint64_t &data_size);
+
+ public:
+  bool CheckOptions(CpuOptions *options, const bool &compressor);
+
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size);
+
+  bool Compress(const char *const uncompressed_data,
+                const uint64_t &uncompressed_data_size, char *compressed_data,
+                uint64_t *compressed_data_size);
+
+  void GetDecompressedDataSize(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               uint64_t *decompressed_data_size);
+
+  bool Decompress(const char *const compressed_data,
+                  const uint64_t &compressed_data_size, char *decompressed_data,
+                  uint64_t *decompressed_data_size);
+
+  void GetTitle();
+
+  bool GetModeInformation(std::vector<std::string> *mode_information = nullptr,
+                          uint8_t *minimum_mode = nullptr,
+                          uint8_t *maximum_mode = nullptr,
+                          const uint8_t &compression_level = 0);
+
+  std::string GetModeName(const uint8_t &mode);
+
+  // The name of the residue library, as in "zero(lz4)"
+  bool SetArguments(const std::string &arguments);
+
+  void Reset();
+
+  // The nonzero bytes can be compressed by another library (e.g., "lz4")
+  explicit ZeroLibrary(const std::string &residue_library_name = "");
+  ~ZeroLibrary();
+};
@@ -0,0 +1,450 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_libraries.hpp>
+#include <cpu_options.hpp>
+#include <zero_library.hpp>
+
+// Format: uncompressed size, map size and packed size, followed by the map
+// (bitmap of nonzero bytes or list of runs of zero and nonzero words) and the
+// nonzero bytes, compressed by the residue library if there is one
+static const uint64_t kHeaderSize = 3 * sizeof(uint64_t);
+
+static void PutVarint(uint64_t value, std::vector<uint8_t> *output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  output->push_back(static_cast<uint8_t>(value));
+}
+
+static bool GetVarint(const uint8_t **input, const uint8_t *end,
+                      uint64_t *value) {
+  *value = 0;
+  for (uint8_t shift = 0; *input < end && shift < 64; shift += 7) {
+    uint8_t byte = *(*input)++;
+    *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+static inline uint64_t LoadWord(const uint8_t *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+CpuOptions ZeroLibrary::GetResidueOptions(const CpuOptions &options) {
+  // The mode belongs to zero, the rest of options are for the residue library
+  CpuOptions residue_options;
+  if (options.CompressionLevelIsSet()) {
+    residue_options.SetCompressionLevel(options.GetCompressionLevel());
+  }
+  if (options.WindowSizeIsSet()) {
+    residue_options.SetWindowSize(options.GetWindowSize());
+  }
+  if (options.NumberThreadsIsSet()) {
+    residue_options.SetNumberThreads(options.GetNumberThreads());
+  }
+  return residue_options;
+}
+
+bool ZeroLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
+  return CpuCompressionLibrary::CheckMode("zero", options, 0, 1);
+}
+
+bool ZeroLibrary::SetOptionsCompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsCompressor(options)};
+  if (result && residue_) {
+    CpuOptions residue_options = GetResidueOptions(*options);
+    initialized_compressor_ = result =
+        residue_->SetOptionsCompressor(&residue_options);
+  }
+  return result;
+}
+
+bool ZeroLibrary::SetOptionsDecompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsDecompressor(options)};
+  if (result && residue_) {
+    CpuOptions residue_options = GetResidueOptions(*options);
+    initialized_decompressor_ = result =
+        residue_->SetOptionsDecompressor(&residue_options);
+  }
+  return result;
+}
+
+void ZeroLibrary::GetCompressedDataSize(const char *const uncompressed_data,
+                                        const uint64_t &uncompressed_data_size,
+                                        uint64_t *compressed_data_size) {
+  // Both maps take at most one byte for every 8 bytes
+  uint64_t packed_size = uncompressed_data_size;
+  // The residue library compresses the packed bytes, not the data
+  if (residue_) {
+    residue_->GetCompressedDataSize(nullptr, uncompressed_data_size,
+                                    &packed_size);
+  }
+  *compressed_data_size =
+      kHeaderSize + uncompressed_data_size / 8 + 16 + packed_size;
+}
+
+uint64_t ZeroLibrary::EncodeBitmap(const uint8_t *data,
+                                   const uint64_t &data_size, uint8_t *bitmap,
+                                   uint8_t *packed) {
+  uint8_t *packed_end = packed;
+  uint64_t i{0};
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= data_size; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    uint32_t nonzero = ~_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)) & 0xFFFF;
+    bitmap[i / 8] = static_cast<uint8_t>(nonzero);
+    bitmap[i / 8 + 1] = static_cast<uint8_t>(nonzero >> 8);
+    if (nonzero == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(packed_end), x);
+      packed_end += 16;
+    } else {
+      while (nonzero) {
+        *packed_end++ = data[i + __builtin_ctz(nonzero)];
+        nonzero &= nonzero - 1;
+      }
+    }
+  }
+#endif
+  for (; i < data_size; i += 8) {
+    uint8_t bits{0};
+    for (uint8_t j = 0; j < 8 && i + j < data_size; ++j) {
+      if (data[i + j]) {
+        bits |= 1 << j;
+        *packed_end++ = data[i + j];
+      }
+    }
+    bitmap[i / 8] = bits;
+  }
+  return packed_end - packed;
+}
+
+bool ZeroLibrary::DecodeBitmap(const uint8_t *bitmap, const uint8_t *packed,
+                               const uint64_t &packed_size, uint8_t *data,
+                               const uint64_t &data_size) {
+  const uint8_t *packed_end = packed + packed_size;
+  for (uint64_t i = 0; i < data_size; i += 8) {
+    // Blocks of 64 zero or nonzero bytes are found with one comparison
+    if (i % 64 == 0 && i + 64 <= data_size) {
+      const uint64_t block_bits = LoadWord(bitmap + i / 8);
+      if (block_bits == 0) {
+        memset(data + i, 0, 64);
+        i += 56;
+        continue;
+      } else if (block_bits == ~0ULL &&
+                 static_cast<uint64_t>(packed_end - packed) >= 64) {
+        memcpy(data + i, packed, 64);
+        packed += 64;
+        i += 56;
+        continue;
+      }
+    }
+    const uint8_t bits = bitmap[i / 8];
+    if (static_cast<uint64_t>(packed_end - packed) <
+        static_cast<uint64_t>(__builtin_popcount(bits))) {
+      return false;
+    }
+    if (i + 8 <= data_size && bits == 0) {
+      memset(data + i, 0, 8);
+    } else if (i + 8 <= data_size && bits == 0xFF) {
+      memcpy(data + i, packed, 8);
+      packed += 8;
+    } else {
+      for (uint8_t j = 0; j < 8 && i + j < data_size; ++j) {
+        data[i + j] = (bits & (1 << j)) ? *packed++ : 0;
+      }
+    }
+  }
+  return packed == packed_end;
+}
+
+void ZeroLibrary::EncodeRuns(const uint8_t *data, const uint64_t &data_size) {
+  // Pairs of runs of zero and nonzero 8-byte words
+  const uint64_t words = data_size / 8;
+  uint64_t i{0}, start;
+  map_.clear();
+  while (i < words) {
+    start = i;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 2 <= words &&
+           _mm_movemask_epi8(_mm_cmpeq_epi8(
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 8 * i)),
+               zero)) == 0xFFFF) {
+      i += 2;
+    }
+#endif
+    while (i < words && LoadWord(data + 8 * i) == 0) ++i;
+    PutVarint(i - start, &map_);
+    start = i;
+    while (i < words && LoadWord(data + 8 * i) != 0) ++i;
+    PutVarint(i - start, &map_);
+  }
+}
+
+uint64_t ZeroLibrary::PackRuns(const uint8_t *data, const uint64_t &data_size,
+                               uint8_t *packed) {
+  const uint8_t *runs = map_.data(), *runs_end = map_.data() + map_.size();
+  uint64_t zero_words, nonzero_words, position{0}, packed_size{0};
+  while (GetVarint(&runs, runs_end, &zero_words) &&
+         GetVarint(&runs, runs_end, &nonzero_words)) {
+    position += 8 * zero_words;
+    memcpy(packed + packed_size, data + position, 8 * nonzero_words);
+    packed_size += 8 * nonzero_words;
+    position += 8 * nonzero_words;
+  }
+  // The last bytes that do not fill a word are always packed
+  if (data_size > position) {
+    memcpy(packed + packed_size, data + position, data_size - position);
+  }
+  return packed_size + data_size - position;
+}
+
+bool ZeroLibrary::DecodeRuns(const uint8_t *runs, const uint64_t &runs_size,
+                             const uint8_t *packed, const uint64_t &packed_size,
+                             uint8_t *data, const uint64_t &data_size) {
+  const uint8_t *runs_end = runs + runs_size;
+  uint64_t zero_words, nonzero_words, position{0}, packed_position{0};
+  const uint64_t words = data_size / 8;
+  bool result{true};
+  while (result && runs < runs_end) {
+    result = GetVarint(&runs, runs_end, &zero_words) &&
+             GetVarint(&runs, runs_end, &nonzero_words) &&
+             zero_words <= words - position / 8 &&
+             nonzero_words <= words - position / 8 - zero_words &&
+             8 * nonzero_words <= packed_size - packed_position;
+    if (result) {
+      memset(data + position, 0, 8 * zero_words);
+      position += 8 * zero_words;
+      memcpy(data + position, packed + packed_position, 8 * nonzero_words);
+      position += 8 * nonzero_words;
+      packed_position += 8 * nonzero_words;
+    }
+  }
+  if (result && position == 8 * words &&
+      packed_size - packed_position == data_size - position) {
+    memcpy(data + position, packed + packed_position, data_size - position);
+  } else {
+    result = false;
+  }
+  return result;
+}
+
+bool ZeroLibrary::Compress(const char *const uncompressed_data,
+                           const uint64_t &uncompressed_data_size,
+                           char *compressed_data,
+                           uint64_t *compressed_data_size) {
+  bool result{initialized_compressor_};
+  if (result) {
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(uncompressed_data);
+    uint64_t map_size{(uncompressed_data_size + 7) / 8};
+    if (options_.GetMode() == 1) {
+      EncodeRuns(data, uncompressed_data_size);
+      map_size = map_.size();
+    }
+    uint64_t compressed_bytes{0};
+    uint8_t *map = reinterpret_cast<uint8_t *>(compressed_data + kHeaderSize);
+    // The nonzero bytes are packed in the output, unless they do not fit or
+    // they are compressed later
+    uint8_t *packed = map + map_size;
+    if (residue_ || kHeaderSize + map_size + uncompressed_data_size >
+                        *compressed_data_size) {
+      if (packed_.size() < uncompressed_data_size) {
+        packed_.resize(uncompressed_data_size);
+      }
+      packed = reinterpret_cast<uint8_t *>(packed_.data());
+    }
+    result = kHeaderSize + map_size <= *compressed_data_size;
+    if (result) {
+      uint64_t packed_size{0};
+      if (options_.GetMode() == 0) {
+        packed_size = EncodeBitmap(data, uncompressed_data_size, map, packed);
+      } else {
+        if (map_size) memcpy(map, map_.data(), map_size);
+        packed_size = PackRuns(data, uncompressed_data_size, packed);
+      }
+      // The output can be inside a chain, so the header may not be aligned
+      const uint64_t header[3] = {uncompressed_data_size, map_size,
+                                  packed_size};
+      memcpy(compressed_data, header, kHeaderSize);
+      compressed_bytes = kHeaderSize + map_size;
+      uint64_t output_size = *compressed_data_size - compressed_bytes;
+      if (residue_) {
+        // The size given to a library that fails is not valid
+        if (packed_size == 0) {
+          output_size = 0;
+        } else {
+          result = residue_->Compress(packed_.data(), packed_size,
+                                      compressed_data + compressed_bytes,
+                                      &output_size);
+        }
+        compressed_bytes += output_size;
+      } else {
+        result = packed_size <= output_size;
+        if (result && packed == reinterpret_cast<uint8_t *>(packed_.data())) {
+          memcpy(compressed_data + compressed_bytes, packed, packed_size);
+        }
+        compressed_bytes += packed_size;
+      }
+    }
+    if (result && compressed_bytes <= *compressed_data_size) {
+      *compressed_data_size = compressed_bytes;
+    } else {
+      std::cout << "ERROR: zero error when compress data" << std::endl;
+      result = false;
+    }
+  }
+  return result;
+}
+
+void ZeroLibrary::GetDecompressedDataSize(const char *const compressed_data,
+                                          const uint64_t &compressed_data_size,
+                                          uint64_t *decompressed_data_size) {
+  if (compressed_data_size >= kHeaderSize) {
+    memcpy(decompressed_data_size, compressed_data, sizeof(uint64_t));
+  } else {
+    *decompressed_data_size = 0;
+  }
+}
+
+bool ZeroLibrary::Decompress(const char *const compressed_data,
+                             const uint64_t &compressed_data_size,
+                             char *decompressed_data,
+                             uint64_t *decompressed_data_size) {
+  bool result{initialized_decompressor_ &&
+              compressed_data_size >= kHeaderSize};
+  if (result) {
+    uint64_t header[3];
+    memcpy(header, compressed_data, kHeaderSize);
+    const uint64_t uncompressed_data_size = header[0];
+    const uint64_t map_size = header[1];
+    uint64_t packed_size = header[2];
+    const uint8_t *map =
+        reinterpret_cast<const uint8_t *>(compressed_data + kHeaderSize);
+    const uint8_t *packed = map + map_size;
+    result = uncompressed_data_size <= *decompressed_data_size &&
+             packed_size <= uncompressed_data_size &&
+             map_size <= compressed_data_size - kHeaderSize &&
+             (options_.GetMode() == 1 ||
+              map_size == (uncompressed_data_size + 7) / 8);
+    const uint64_t input_size = compressed_data_size - kHeaderSize - map_size;
+    if (result && residue_ && packed_size) {
+      if (packed_.size() < packed_size) packed_.resize(packed_size);
+      uint64_t residue_size = packed_size;
+      result = residue_->Decompress(reinterpret_cast<const char *>(packed),
+                                    input_size, packed_.data(),
+                                    &residue_size) &&
+               residue_size == packed_size;
+      packed = reinterpret_cast<const uint8_t *>(packed_.data());
+    } else if (result) {
+      result = packed_size <= input_size;
+    }
+    if (result) {
+      uint8_t *data = reinterpret_cast<uint8_t *>(decompressed_data);
+      if (options_.GetMode() == 0) {
+        result = DecodeBitmap(map, packed, packed_size, data,
+                              uncompressed_data_size);
+      } else {
+        result = DecodeRuns(map, map_size, packed, packed_size, data,
+                            uncompressed_data_size);
+      }
+    }
+    if (!result) {
+      std::cout << "ERROR: zero error when decompress data" << std::endl;
+    } else {
+      *decompressed_data_size = uncompressed_data_size;
+    }
+  }
+  return result;
+}
+
+void ZeroLibrary::GetTitle() {
+  CpuCompressionLibrary::GetTitle(
+      "zero",
+      "Encoder of zero bytes for sparse data, the nonzero bytes are packed");
+}
+
+bool ZeroLibrary::GetModeInformation(std::vector<std::string> *mode_information,
+                                     uint8_t *minimum_mode,
+                                     uint8_t *maximum_mode,
+                                     const uint8_t &compression_level) {
+  if (minimum_mode) *minimum_mode = 0;
+  if (maximum_mode) *maximum_mode = 1;
+  if (mode_information) {
+    mode_information->clear();
+    mode_information->push_back("Available values [0-1]");
+    mode_information->push_back("0: " + modes_[0] +
+                                " of nonzero bytes, for scattered zeros");
+    mode_information->push_back(
+        "1: " + modes_[1] + " of zero 8-byte words, for long zero runs");
+    mode_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
+std::string ZeroLibrary::GetModeName(const uint8_t &mode) {
+  std::string result = "ERROR";
+  if (mode < number_of_modes_) {
+    result = modes_[mode];
+  }
+  return result;
+}
+
+bool ZeroLibrary::SetArguments(const std::string &arguments) {
+  CpuCompressionLibraries libraries;
+  uint16_t library_id{0};
+  bool result{arguments.empty() ||
+              libraries.GetLibraryId(arguments, &library_id)};
+  if (result) {
+    delete residue_;
+    residue_ = nullptr;
+    if (!arguments.empty()) {
+      residue_ = libraries.GetCompressionLibrary(library_id);
+    }
+    initialized_compressor_ = false;
+    initialized_decompressor_ = false;
+  } else {
+    std::cout << "ERROR: The residue library " << arguments
+              << " of zero does not exist" << std::endl;
+  }
+  return result;
+}
+
+void ZeroLibrary::Reset() {
+  if (residue_) residue_->Reset();
+  CpuCompressionLibrary::Reset();
+}
+
+ZeroLibrary::ZeroLibrary(const std::string &residue_library_name) {
+  number_of_modes_ = 2;
+  modes_ = new std::string[number_of_modes_];
+  modes_[0] = "Bitmap";
+  modes_[1] = "Runs";
+  residue_ = nullptr;
+  if (!residue_library_name.empty()) {
+    residue_ = CpuCompressionLibraries().GetCompressionLibrary(
+        residue_library_name);
+  }
+}
+
+ZeroLibrary::~ZeroLibrary() {
+  delete residue_;
+  delete[] modes_;
+}
@@ -20,8 +20,8 @@
 class ZlingReader : public baidu::zling::Inputter {
  private:
   const char *buffer_;
-  uint64_t buffer_size_;
-  uint64_t total_read_;
+  const char *const buffer_begin_;
+  const char *const buffer_end_;
   bool error_;
 
  public:
@@ -35,8 +35,8 @@ class ZlingReader : public baidu::zling::Inputter {
 class ZlingWriter : public baidu::zling::Outputter {
  private:
   char *buffer_;
-  uint64_t buffer_size_;
-  uint64_t total_write_;
+  char *const buffer_begin_;
+  char *const buffer_end_;
   bool error_;
 
  public:
@@ -7,59 +7,55 @@
  */
 
 #include <libzling.h>
+#include <string.h>
 
 // CPU-SMASH LIBRARIES
 #include <cpu_options.hpp>
 #include <zling_library.hpp>
 
 size_t ZlingReader::GetData(unsigned char *buf, size_t len) {
-  uint64_t real_size{0};
-  if (buf && len && buffer_ && buffer_size_) {
-    real_size = (len > buffer_size_) ? buffer_size_ : len;
+  uint64_t real_size = buffer_end_ - buffer_;
+  if (len < real_size) real_size = len;
+  if (real_size) {
     memcpy(buf, buffer_, real_size);
     buffer_ += real_size;
-    buffer_size_ -= real_size;
-    total_read_ += real_size;
   } else {
     error_ = true;
   }
   return real_size;
 }
 
-bool ZlingReader::IsEnd() { return !buffer_size_; }
+bool ZlingReader::IsEnd() { return buffer_ == buffer_end_; }
 
 bool ZlingReader::IsErr() { return error_; }
 
-size_t ZlingReader::GetInputSize() { return total_read_; }
+size_t ZlingReader::GetInputSize() { return buffer_ - buffer_begin_; }
 
 ZlingReader::ZlingReader(const char *buffer, const uint64_t &buffer_size)
     : buffer_(buffer),
-      buffer_size_(buffer_size),
-      total_read_(0),
+      buffer_begin_(buffer),
+      buffer_end_(buffer ? buffer + buffer_size : buffer),
       error_(false) {}
 
 size_t ZlingWriter::PutData(unsigned char *buf, size_t len) {
-  uint64_t real_size{0};
-  if (buf && len && buffer_ && buffer_size_) {
-    real_size = (len > buffer_size_) ? buffer_size_ : len;
+  uint64_t real_size = buffer_end_ - buffer_;
+  if (len < real_size) real_size = len;
+  if (real_size) {
     memcpy(buffer_, buf, real_size);
     buffer_ += real_size;
-    buffer_size_ -= real_size;
-    total_write_ += real_size;
-  } else {
-    error_ = true;
   }
+  if (real_size != len) error_ = true;
   return real_size;
 }
 
 bool ZlingWriter::IsErr() { return error_; }
 
-size_t ZlingWriter::GetOutputSize() { return total_write_; }
+size_t ZlingWriter::GetOutputSize() { return buffer_ - buffer_begin_; }
 
 ZlingWriter::ZlingWriter(char *buffer, const uint64_t &buffer_size)
     : buffer_(buffer),
-      buffer_size_(buffer_size),
-      total_write_(0),
+      buffer_begin_(buffer),
+      buffer_end_(buffer ? buffer + buffer_size : buffer),
       error_(false) {}
 
 bool ZlingLibrary::CheckOptions(CpuOptions *options, const bool &compressor) {
@@ -16,7 +16,17 @@
 #include <cpu_compression_library.hpp>
 #include <cpu_options.hpp>
 
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
 class ZstdLibrary : public CpuCompressionLibrary {
+ private:
+  // Contexts for the compression against a reference
+  ZSTD_CCtx_s *compression_context_;
+  ZSTD_DCtx_s *decompression_context_;
+
+  static int GetWindowLog(const uint64_t &size);
+
  public:
   bool CheckOptions(CpuOptions *options, const bool &compressor);
 
@@ -32,6 +42,19 @@ class ZstdLibrary : public CpuCompressionLibrary {
                   const uint64_t &compressed_data_size, char *decompressed_data,
                   uint64_t *decompressed_data_size);
 
+  bool CompressAgainst(const char *const reference_data,
+                       const uint64_t &reference_data_size,
+                       const char *const uncompressed_data,
+                       const uint64_t &uncompressed_data_size,
+                       char *compressed_data, uint64_t *compressed_data_size);
+
+  bool DecompressAgainst(const char *const reference_data,
+                         const uint64_t &reference_data_size,
+                         const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size);
+
   void GetTitle();
 
   bool GetCompressionLevelInformation(
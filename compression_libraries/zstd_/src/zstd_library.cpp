@@ -63,6 +63,82 @@ bool ZstdLibrary::Decompress(const char *const compressed_data,
   return result;
 }
 
+int ZstdLibrary::GetWindowLog(const uint64_t &size) {
+  ZSTD_bounds bounds = ZSTD_cParam_getBounds(ZSTD_c_windowLog);
+  int window_log{bounds.lowerBound};
+  while (window_log < bounds.upperBound && (1ULL << window_log) < size) {
+    ++window_log;
+  }
+  return window_log;
+}
+
+bool ZstdLibrary::CompressAgainst(const char *const reference_data,
+                                  const uint64_t &reference_data_size,
+                                  const char *const uncompressed_data,
+                                  const uint64_t &uncompressed_data_size,
+                                  char *compressed_data,
+                                  uint64_t *compressed_data_size) {
+  bool result{initialized_compressor_};
+  if (result) {
+    if (!compression_context_) compression_context_ = ZSTD_createCCtx();
+    // The reference is a prefix of the data, as in zstd --patch-from, so the
+    // window has to reach the beginning of the reference
+    const int window_log =
+        GetWindowLog(reference_data_size + uncompressed_data_size);
+    ZSTD_CCtx_reset(compression_context_, ZSTD_reset_session_and_parameters);
+    ZSTD_CCtx_setParameter(compression_context_, ZSTD_c_compressionLevel,
+                           options_.GetCompressionLevel());
+    ZSTD_CCtx_setParameter(compression_context_, ZSTD_c_windowLog, window_log);
+    if (options_.GetCompressionLevel() == 1) {
+      // Otherwise the small hash table of level 1 misses most of the reference
+      ZSTD_CCtx_setParameter(compression_context_, ZSTD_c_hashLog,
+                             window_log < 22 ? window_log : 22);
+    }
+    if (window_log > 27) {
+      ZSTD_CCtx_setParameter(compression_context_,
+                             ZSTD_c_enableLongDistanceMatching, 1);
+    }
+    ZSTD_CCtx_refPrefix(compression_context_, reference_data,
+                        reference_data_size);
+    uint64_t new_size = ZSTD_compress2(
+        compression_context_, compressed_data, *compressed_data_size,
+        uncompressed_data, uncompressed_data_size);
+    if (ZSTD_isError(new_size) || new_size > *compressed_data_size) {
+      std::cout << "ERROR: zstd error when compress data" << std::endl;
+      result = false;
+    }
+    *compressed_data_size = new_size;
+  }
+  return result;
+}
+
+bool ZstdLibrary::DecompressAgainst(const char *const reference_data,
+                                    const uint64_t &reference_data_size,
+                                    const char *const compressed_data,
+                                    const uint64_t &compressed_data_size,
+                                    char *decompressed_data,
+                                    uint64_t *decompressed_data_size) {
+  bool result{initialized_decompressor_};
+  if (result) {
+    if (!decompression_context_) decompression_context_ = ZSTD_createDCtx();
+    ZSTD_DCtx_reset(decompression_context_, ZSTD_reset_session_and_parameters);
+    ZSTD_DCtx_setParameter(
+        decompression_context_, ZSTD_d_windowLogMax,
+        GetWindowLog(reference_data_size + *decompressed_data_size));
+    ZSTD_DCtx_refPrefix(decompression_context_, reference_data,
+                        reference_data_size);
+    uint64_t new_size = ZSTD_decompressDCtx(
+        decompression_context_, decompressed_data, *decompressed_data_size,
+        compressed_data, compressed_data_size);
+    if (new_size != *decompressed_data_size) {
+      std::cout << "ERROR: zstd error when decompress data" << std::endl;
+      result = false;
+    }
+    *decompressed_data_size = new_size;
+  }
+  return result;
+}
+
 void ZstdLibrary::GetTitle() {
   CpuCompressionLibrary::GetTitle(
       "zstd",
@@ -83,6 +159,10 @@ bool ZstdLibrary::GetCompressionLevelInformation(
   return true;
 }
 
-ZstdLibrary::ZstdLibrary() {}
+ZstdLibrary::ZstdLibrary()
+    : compression_context_(nullptr), decompression_context_(nullptr) {}
 
-ZstdLibrary::~ZstdLibrary() {}
+ZstdLibrary::~ZstdLibrary() {
+  ZSTD_freeCCtx(compression_context_);
+  ZSTD_freeDCtx(decompression_context_);
+}
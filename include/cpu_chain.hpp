@@ -0,0 +1,77 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_library.hpp>
+#include <cpu_filter.hpp>
+#include <cpu_options.hpp>
+
+// Stage of a chain, which is a filter or a compression library
+struct CpuChainStage {
+  CpuFilter *filter;
+  CpuCompressionLibrary *library;
+  uint8_t mode;
+  bool mode_set;
+};
+
+// Compression library that runs several filters and libraries one after the
+// other, given as "stage|stage|..." (e.g., "shuffle4|lz4|huf"). The stages
+// are recorded in the compressed data, so the decompressor replays them in
+// reverse order
+class CpuChain : public CpuCompressionLibrary {
+ private:
+  std::string chain_;
+  std::vector<CpuChainStage> stages_;
+  std::vector<char> buffers_[2];
+
+  bool ParseStage(const std::string &stage_name, CpuChainStage *stage);
+
+  bool Parse(const std::string &chain);
+
+  void Clear();
+
+  bool SetOptionsStages(const bool &compressor);
+
+  uint64_t GetHeaderSize();
+
+  char *GetBuffer(const char *const data, const uint64_t &size);
+
+ public:
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size);
+
+  bool Compress(const char *const uncompressed_data,
+                const uint64_t &uncompressed_data_size, char *compressed_data,
+                uint64_t *compressed_data_size);
+
+  void GetDecompressedDataSize(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               uint64_t *decompressed_data_size);
+
+  bool Decompress(const char *const compressed_data,
+                  const uint64_t &compressed_data_size, char *decompressed_data,
+                  uint64_t *decompressed_data_size);
+
+  void GetTitle();
+
+  bool IsStateless();
+
+  explicit CpuChain(const std::string &chain);
+  ~CpuChain();
+};
@@ -0,0 +1,51 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_options.hpp>
+
+// Process-wide LRU cache of compressed data, so compressing again the same
+// data with the same library and options copies the previous result. It is
+// disabled by default
+class CpuCompressionCache {
+ public:
+  // Bytes of the data and the compressed data kept in the cache. 0 disables
+  // and empties the cache
+  static void SetMaximumSize(const uint64_t &maximum_size);
+
+  static uint64_t GetMaximumSize();
+
+  static uint64_t GetUsedSize();
+
+  static uint64_t GetHits();
+
+  static uint64_t GetMisses();
+
+  // Empties the cache and resets the hits and misses
+  static void Clear();
+
+  // Identifies the compression library and its options
+  static std::string GetKey(const std::string &library_name,
+                            const CpuOptions &options);
+
+  // Copies the compressed data if the data is in the cache and it fits.
+  // The hash is the one of CpuHash
+  static bool Find(const uint64_t &hash, const std::string &key,
+                   const char *const data, const uint64_t &data_size,
+                   char *compressed_data, uint64_t *compressed_data_size);
+
+  static void Add(const uint64_t &hash, const std::string &key,
+                  const char *const data, const uint64_t &data_size,
+                  const char *const compressed_data,
+                  const uint64_t &compressed_data_size);
+};
@@ -8,9 +8,8 @@
 
 #pragma once
 
-#include <functional>
+#include <cstdint>
 #include <iostream>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -18,12 +17,20 @@
 #include <cpu_compression_library.hpp>
 
 class CpuCompressionLibraries {
- private:
-  std::map<std::string, std::function<CpuCompressionLibrary *()>> map_;
-
  public:
+  bool GetLibraryId(const std::string &library_name, uint16_t *library_id);
+
   CpuCompressionLibrary *GetCompressionLibrary(const std::string &library_name);
 
+  CpuCompressionLibrary *GetCompressionLibrary(const uint16_t &library_id);
+
+  // Takes an idle instance of the library, or a new one if there is none. An
+  // idle instance is reset, so its options are not set
+  CpuCompressionLibrary *CheckOutCompressionLibrary(const uint16_t &library_id);
+
+  void ReturnCompressionLibrary(const uint16_t &library_id,
+                                CpuCompressionLibrary *library);
+
   std::vector<std::string> GetNameLibraries();
 
   void GetListInformation();
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -20,6 +21,7 @@ class CpuCompressionLibrary {
   CpuOptions options_;
   bool initialized_compressor_;
   bool initialized_decompressor_;
+  std::vector<char> reference_buffer_;
 
   virtual bool CheckOptions(CpuOptions *options, const bool &compressor);
 
@@ -45,6 +47,29 @@ class CpuCompressionLibrary {
                           char *decompressed_data,
                           uint64_t *decompressed_data_size) = 0;
 
+  // Compresses the data using a reference (e.g., a previous version of the
+  // same data) which must be given again to decompress
+  virtual bool CompressAgainst(const char *const reference_data,
+                               const uint64_t &reference_data_size,
+                               const char *const uncompressed_data,
+                               const uint64_t &uncompressed_data_size,
+                               char *compressed_data,
+                               uint64_t *compressed_data_size);
+
+  virtual bool DecompressAgainst(const char *const reference_data,
+                                 const uint64_t &reference_data_size,
+                                 const char *const compressed_data,
+                                 const uint64_t &compressed_data_size,
+                                 char *decompressed_data,
+                                 uint64_t *decompressed_data_size);
+
+  virtual bool Sink(const char *const data, const uint64_t &data_size,
+                    uint64_t *sunk_data_size);
+
+  virtual bool Poll(char *data, uint64_t *data_size, bool *more_data);
+
+  virtual bool Finish(bool *finished);
+
   virtual void GetTitle() = 0;
 
   void GetTitle(const std::string &library_name,
@@ -84,6 +109,19 @@ class CpuCompressionLibrary {
 
   virtual std::string GetFlagsName(const uint8_t &flags);
 
+  // Arguments given in the name of the library, as "name(arguments)" (e.g.,
+  // the residue library of zero). By default, only no arguments are valid
+  virtual bool SetArguments(const std::string &arguments);
+
+  // False when the compressed data depends on the previous messages, so the
+  // same data can not be compressed only once (e.g., the compression cache)
+  virtual bool IsStateless();
+
+  // Forgets the options, as a new instance. The workspaces can be kept, but
+  // the state that depends on the options must be freed (e.g., the threads
+  // of the budget). Called when a pooled instance is reused
+  virtual void Reset();
+
   bool CompareData(const char *const uncompressed_data,
                    const uint64_t &uncompressed_data_size,
                    const char *const decompressed_data,
@@ -115,6 +153,10 @@ class CpuCompressionLibrary {
                           const uint8_t &minimum_back_reference,
                           const uint8_t &maximum_back_reference);
 
+  void ParallelFor(const uint64_t &number_of_tasks,
+                   const uint8_t &number_threads,
+                   const std::function<void(const uint64_t &task)> &function);
+
   virtual CpuOptions GetOptions();
 
   CpuCompressionLibrary();
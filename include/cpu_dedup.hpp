@@ -0,0 +1,79 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_options.hpp>
+#include <cpu_smash.hpp>
+
+// Deduplication of chunks in front of CpuSmash. The sender and the receiver
+// keep the same bounded cache of chunks, so the chunks the receiver already
+// has are sent as their position in the cache and only the new ones are
+// compressed. A CpuDedup only compresses or only decompresses, and the data
+// must be decompressed in the same order it was compressed
+class CpuDedup {
+ private:
+  CpuSmash smash_;
+  uint64_t chunk_size_;
+  uint32_t cache_chunks_;
+  // Chunks of the cache, replaced in order when it is full
+  std::vector<char> cache_;
+  uint32_t used_chunks_;
+  uint32_t next_chunk_;
+  // Sender: position in the cache of the hash of every chunk
+  std::unordered_map<uint64_t, uint32_t> positions_;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> tokens_;
+  std::vector<char> new_data_;
+  uint64_t duplicated_chunks_;
+  uint64_t total_chunks_;
+
+  uint64_t GetHeaderSize(const uint64_t &data_size);
+
+  // Returns the position of the chunk in the cache
+  uint32_t AddChunk(const char *const chunk);
+
+ public:
+  bool SetOptionsCompressor(CpuOptions *options);
+
+  bool SetOptionsDecompressor(CpuOptions *options);
+
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size);
+
+  bool Compress(const char *const uncompressed_data,
+                const uint64_t &uncompressed_data_size, char *compressed_data,
+                uint64_t *compressed_data_size);
+
+  void GetDecompressedDataSize(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               uint64_t *decompressed_data_size);
+
+  bool Decompress(const char *const compressed_data,
+                  const uint64_t &compressed_data_size, char *decompressed_data,
+                  uint64_t *decompressed_data_size);
+
+  // Empties the cache. After an error, it has to be done in both sides
+  void Clear();
+
+  // Chunks sent as a position in the cache, and all the chunks
+  uint64_t GetDuplicatedChunks() const;
+
+  uint64_t GetTotalChunks() const;
+
+  CpuDedup(const std::string &compression_library_name,
+           const uint64_t &chunk_size = 64 * 1024,
+           const uint32_t &cache_chunks = 1024);
+};
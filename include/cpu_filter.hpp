@@ -0,0 +1,51 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_options.hpp>
+
+// Reversible transform applied to the data before any compression library,
+// keeping its size. The filter and the element size are taken from CpuOptions
+class CpuFilter {
+ private:
+  uint8_t number_of_filters_;
+  std::string *filters_;
+  uint8_t filter_;
+  uint8_t element_size_;
+  std::vector<char> buffer_;
+  std::vector<char> scratch_;
+
+ public:
+  bool SetOptions(CpuOptions *options);
+
+  bool IsSet() const;
+
+  // Returns the filtered data, or the same data if there is no filter
+  const char *Apply(const char *const data, const uint64_t &data_size);
+
+  // Reverts the filter in place
+  void Revert(char *data, const uint64_t &data_size);
+
+  bool GetFilterInformation(std::vector<std::string> *filter_information,
+                            uint8_t *minimum_filter, uint8_t *maximum_filter);
+
+  bool GetElementSizeInformation(
+      std::vector<std::string> *element_size_information,
+      uint8_t *minimum_size, uint8_t *maximum_size);
+
+  std::string GetFilterName(const uint8_t &filter);
+
+  CpuFilter();
+  ~CpuFilter();
+};
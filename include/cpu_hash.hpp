@@ -0,0 +1,18 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Fast non-cryptographic hash of the content of the buffers. The hashes are
+// not sent to other nodes, so they can change between versions
+class CpuHash {
+ public:
+  static uint64_t Hash(const char *const data, const uint64_t &data_size);
+};
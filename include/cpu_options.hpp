@@ -9,6 +9,25 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
+
+// Types of the elements of the data. They are hints for the libraries and the
+// filters, the data is compressed as bytes
+enum CpuDataType : uint8_t {
+  kCpuInt8,
+  kCpuUint8,
+  kCpuInt16,
+  kCpuUint16,
+  kCpuInt32,
+  kCpuUint32,
+  kCpuInt64,
+  kCpuUint64,
+  kCpuFloat16,
+  kCpuBfloat16,
+  kCpuFloat32,
+  kCpuFloat64,
+  kCpuText
+};
 
 class CpuOptions {
  private:
@@ -26,6 +45,14 @@ class CpuOptions {
   bool number_threads_set_;
   uint8_t back_reference_;
   bool back_reference_set_;
+  uint8_t filter_;
+  bool filter_set_;
+  uint8_t element_size_;
+  bool element_size_set_;
+  uint8_t data_type_;
+  bool data_type_set_;
+  std::vector<uint64_t> shape_;
+  bool shape_set_;
 
  public:
   void SetCompressionLevel(const uint8_t &compression_level);
@@ -35,6 +62,12 @@ class CpuOptions {
   void SetFlags(const uint8_t &flags);
   void SetNumberThreads(const uint8_t &number_threads);
   void SetBackReference(const uint8_t &back_reference);
+  void SetFilter(const uint8_t &filter);
+  void SetElementSize(const uint8_t &element_size);
+  void SetDataType(const uint8_t &data_type);
+  // Number of elements of every dimension, from the outermost (e.g., rows and
+  // columns of a matrix)
+  void SetShape(const std::vector<uint64_t> &shape);
 
   bool CompressionLevelIsSet() const;
   bool WindowSizeIsSet() const;
@@ -43,6 +76,10 @@ class CpuOptions {
   bool FlagsIsSet() const;
   bool NumberThreadsIsSet() const;
   bool BackReferenceIsSet() const;
+  bool FilterIsSet() const;
+  bool ElementSizeIsSet() const;
+  bool DataTypeIsSet() const;
+  bool ShapeIsSet() const;
 
   uint8_t GetCompressionLevel() const;
   uint32_t GetWindowSize() const;
@@ -51,6 +88,13 @@ class CpuOptions {
   uint8_t GetFlags() const;
   uint8_t GetNumberThreads() const;
   uint8_t GetBackReference() const;
+  uint8_t GetFilter() const;
+  uint8_t GetElementSize() const;
+  uint8_t GetDataType() const;
+  std::vector<uint64_t> GetShape() const;
+
+  // Bytes of an element of the data type, 0 if it is not set
+  uint8_t GetDataTypeSize() const;
 
   CpuOptions();
   ~CpuOptions();
@@ -15,10 +15,13 @@
 // CPU-SMASH LIBRARIES
 #include <cpu_compression_library.hpp>
 #include <cpu_options.hpp>
+#include <cpu_smash_common.hpp>
 
-class CpuSmash {
+class CpuSmash : private CpuSmashCommon {
  private:
   CpuCompressionLibrary *lib;
+  uint16_t library_id_;
+  bool pooled_;
 
  public:
   bool SetOptionsCompressor(CpuOptions *options);
@@ -41,6 +44,26 @@ class CpuSmash {
                   const uint64_t &compressed_data_size, char *decompressed_data,
                   uint64_t *decompressed_data_size);
 
+  bool CompressAgainst(const char *const reference_data,
+                       const uint64_t &reference_data_size,
+                       const char *const uncompressed_data,
+                       const uint64_t &uncompressed_data_size,
+                       char *compressed_data, uint64_t *compressed_data_size);
+
+  bool DecompressAgainst(const char *const reference_data,
+                         const uint64_t &reference_data_size,
+                         const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size);
+
+  bool Sink(const char *const data, const uint64_t &data_size,
+            uint64_t *sunk_data_size);
+
+  bool Poll(char *data, uint64_t *data_size, bool *more_data);
+
+  bool Finish(bool *finished);
+
   void GetTitle();
 
   bool CompareData(const char *const uncompressed_data,
@@ -78,13 +101,26 @@ class CpuSmash {
       uint8_t *minimum_back_reference = nullptr,
       uint8_t *maximum_back_reference = nullptr);
 
+  bool GetFilterInformation(
+      std::vector<std::string> *filter_information = nullptr,
+      uint8_t *minimum_filter = nullptr, uint8_t *maximum_filter = nullptr);
+
+  bool GetElementSizeInformation(
+      std::vector<std::string> *element_size_information = nullptr,
+      uint8_t *minimum_size = nullptr, uint8_t *maximum_size = nullptr);
+
   std::string GetModeName(const uint8_t &mode);
 
   std::string GetFlagsName(const uint8_t &flags);
 
+  std::string GetFilterName(const uint8_t &filter);
+
   CpuOptions GetOptions();
 
-  explicit CpuSmash(const std::string &compression_library_name);
+  explicit CpuSmash(const std::string &compression_library_name,
+                    const bool &pooled = false);
 
   ~CpuSmash();
 };
+
+static_assert(CpuSmashApi<CpuSmash>::value, "CpuSmash API");
@@ -0,0 +1,234 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_cache.hpp>
+#include <cpu_filter.hpp>
+#include <cpu_hash.hpp>
+#include <cpu_options.hpp>
+
+// Work that CpuSmash and CpuSmashT do around the compression library: the
+// filters and the cache. The library calls are given as functions, so
+// CpuSmashT keeps them not virtual
+class CpuSmashCommon {
+ protected:
+  // Identifies the library in the cache
+  std::string name_;
+  CpuFilter filter_;
+  // The reference of CompressAgainst is filtered like the data
+  CpuFilter reference_filter_;
+
+  // Called before the options are given to the library
+  bool SetFilterOptions(CpuOptions *options);
+
+  // Filters are not available in incremental mode
+  bool CheckSink(uint64_t *sunk_data_size);
+
+  // Exits when the name is not the one of a library of that type in
+  // CpuCompressionLibraries, so the cache keeps each library apart
+  void CheckLibraryName(const std::type_info &type);
+
+  template <class CompressFunction>
+  bool CompressFiltered(const CpuOptions &library_options,
+                        const char *const uncompressed_data,
+                        const uint64_t &uncompressed_data_size,
+                        char *compressed_data, uint64_t *compressed_data_size,
+                        const bool &stateless,
+                        const CompressFunction &compress) {
+    // With the cache enabled, the same data is compressed only once. A
+    // library with history has to see all the messages
+    const bool cached{stateless && CpuCompressionCache::GetMaximumSize() > 0};
+    uint64_t hash{0};
+    std::string key;
+    if (cached) {
+      hash = CpuHash::Hash(uncompressed_data, uncompressed_data_size);
+      key = CpuCompressionCache::GetKey(name_, library_options);
+      if (CpuCompressionCache::Find(hash, key, uncompressed_data,
+                                    uncompressed_data_size, compressed_data,
+                                    compressed_data_size)) {
+        return true;
+      }
+    }
+    bool result{compress(filter_.Apply(uncompressed_data,
+                                       uncompressed_data_size),
+                         uncompressed_data_size, compressed_data,
+                         compressed_data_size)};
+    if (result && cached) {
+      CpuCompressionCache::Add(hash, key, uncompressed_data,
+                               uncompressed_data_size, compressed_data,
+                               *compressed_data_size);
+    }
+    return result;
+  }
+
+  template <class DecompressFunction>
+  bool DecompressFiltered(char *decompressed_data,
+                          uint64_t *decompressed_data_size,
+                          const DecompressFunction &decompress) {
+    bool result{decompress(decompressed_data, decompressed_data_size)};
+    if (result) filter_.Revert(decompressed_data, *decompressed_data_size);
+    return result;
+  }
+
+  template <class CompressFunction>
+  bool CompressAgainstFiltered(const char *const reference_data,
+                               const uint64_t &reference_data_size,
+                               const char *const uncompressed_data,
+                               const uint64_t &uncompressed_data_size,
+                               char *compressed_data,
+                               uint64_t *compressed_data_size,
+                               const CompressFunction &compress) {
+    return compress(
+        reference_filter_.Apply(reference_data, reference_data_size),
+        reference_data_size,
+        filter_.Apply(uncompressed_data, uncompressed_data_size),
+        uncompressed_data_size, compressed_data, compressed_data_size);
+  }
+
+  template <class DecompressFunction>
+  bool DecompressAgainstFiltered(const char *const reference_data,
+                                 const uint64_t &reference_data_size,
+                                 char *decompressed_data,
+                                 uint64_t *decompressed_data_size,
+                                 const DecompressFunction &decompress) {
+    bool result{
+        decompress(reference_filter_.Apply(reference_data, reference_data_size),
+                   reference_data_size, decompressed_data,
+                   decompressed_data_size)};
+    if (result) filter_.Revert(decompressed_data, *decompressed_data_size);
+    return result;
+  }
+
+  explicit CpuSmashCommon(const std::string &name);
+};
+
+// Fails to compile when Smash does not have the API of CpuSmash, so CpuSmash
+// and CpuSmashT can not drift apart
+template <class Smash>
+struct CpuSmashApi {
+  static_assert(std::is_same<decltype(&Smash::SetOptionsCompressor),
+                             bool (Smash::*)(CpuOptions *)>::value,
+                "SetOptionsCompressor");
+  static_assert(std::is_same<decltype(&Smash::SetOptionsDecompressor),
+                             bool (Smash::*)(CpuOptions *)>::value,
+                "SetOptionsDecompressor");
+  static_assert(std::is_same<decltype(&Smash::GetCompressedDataSize),
+                             void (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             uint64_t *)>::value,
+                "GetCompressedDataSize");
+  static_assert(std::is_same<decltype(&Smash::Compress),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &, char *,
+                                             uint64_t *)>::value,
+                "Compress");
+  static_assert(std::is_same<decltype(&Smash::GetDecompressedDataSize),
+                             void (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             uint64_t *)>::value,
+                "GetDecompressedDataSize");
+  static_assert(std::is_same<decltype(&Smash::Decompress),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &, char *,
+                                             uint64_t *)>::value,
+                "Decompress");
+  static_assert(std::is_same<decltype(&Smash::CompressAgainst),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             const char *const,
+                                             const uint64_t &, char *,
+                                             uint64_t *)>::value,
+                "CompressAgainst");
+  static_assert(std::is_same<decltype(&Smash::DecompressAgainst),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             const char *const,
+                                             const uint64_t &, char *,
+                                             uint64_t *)>::value,
+                "DecompressAgainst");
+  static_assert(std::is_same<decltype(&Smash::Sink),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             uint64_t *)>::value,
+                "Sink");
+  static_assert(std::is_same<decltype(&Smash::Poll),
+                             bool (Smash::*)(char *, uint64_t *,
+                                             bool *)>::value,
+                "Poll");
+  static_assert(std::is_same<decltype(&Smash::Finish),
+                             bool (Smash::*)(bool *)>::value,
+                "Finish");
+  static_assert(std::is_same<decltype(&Smash::GetTitle),
+                             void (Smash::*)()>::value,
+                "GetTitle");
+  static_assert(std::is_same<decltype(&Smash::CompareData),
+                             bool (Smash::*)(const char *const,
+                                             const uint64_t &,
+                                             const char *const,
+                                             const uint64_t &)>::value,
+                "CompareData");
+  static_assert(std::is_same<decltype(&Smash::GetCompressionLevelInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetCompressionLevelInformation");
+  static_assert(std::is_same<decltype(&Smash::GetWindowSizeInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint32_t *, uint32_t *)>::value,
+                "GetWindowSizeInformation");
+  static_assert(std::is_same<decltype(&Smash::GetModeInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *,
+                                             const uint8_t &)>::value,
+                "GetModeInformation");
+  static_assert(std::is_same<decltype(&Smash::GetWorkFactorInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetWorkFactorInformation");
+  static_assert(std::is_same<decltype(&Smash::GetFlagsInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetFlagsInformation");
+  static_assert(std::is_same<decltype(&Smash::GetNumberThreadsInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetNumberThreadsInformation");
+  static_assert(std::is_same<decltype(&Smash::GetBackReferenceInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetBackReferenceInformation");
+  static_assert(std::is_same<decltype(&Smash::GetFilterInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetFilterInformation");
+  static_assert(std::is_same<decltype(&Smash::GetElementSizeInformation),
+                             bool (Smash::*)(std::vector<std::string> *,
+                                             uint8_t *, uint8_t *)>::value,
+                "GetElementSizeInformation");
+  static_assert(std::is_same<decltype(&Smash::GetModeName),
+                             std::string (Smash::*)(const uint8_t &)>::value,
+                "GetModeName");
+  static_assert(std::is_same<decltype(&Smash::GetFlagsName),
+                             std::string (Smash::*)(const uint8_t &)>::value,
+                "GetFlagsName");
+  static_assert(std::is_same<decltype(&Smash::GetFilterName),
+                             std::string (Smash::*)(const uint8_t &)>::value,
+                "GetFilterName");
+  static_assert(std::is_same<decltype(&Smash::GetOptions),
+                             CpuOptions (Smash::*)()>::value,
+                "GetOptions");
+
+  static constexpr bool value{true};
+};
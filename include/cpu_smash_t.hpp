@@ -0,0 +1,221 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_library.hpp>
+#include <cpu_options.hpp>
+#include <cpu_smash_common.hpp>
+
+// Same API as CpuSmash for a library fixed at compile time (e.g.,
+// CpuSmashT<Lz4Library> lib("lz4")). The library is a member, and the calls
+// are qualified, so they are not virtual and can be inlined. Filters and the
+// cache work as in CpuSmash
+template <class Library>
+class CpuSmashT : private CpuSmashCommon {
+ private:
+  Library lib;
+
+ public:
+  bool SetOptionsCompressor(CpuOptions *options) {
+    return SetFilterOptions(options) &&
+           lib.Library::SetOptionsCompressor(options);
+  }
+
+  bool SetOptionsDecompressor(CpuOptions *options) {
+    return SetFilterOptions(options) &&
+           lib.Library::SetOptionsDecompressor(options);
+  }
+
+  void GetCompressedDataSize(const char *const uncompressed_data,
+                             const uint64_t &uncompressed_data_size,
+                             uint64_t *compressed_data_size) {
+    lib.Library::GetCompressedDataSize(uncompressed_data,
+                                       uncompressed_data_size,
+                                       compressed_data_size);
+  }
+
+  bool Compress(const char *const uncompressed_data,
+                const uint64_t &uncompressed_data_size, char *compressed_data,
+                uint64_t *compressed_data_size) {
+    return CompressFiltered(
+        lib.Library::GetOptions(), uncompressed_data, uncompressed_data_size,
+        compressed_data, compressed_data_size, lib.Library::IsStateless(),
+        [this](const char *const data, const uint64_t &data_size,
+               char *output, uint64_t *output_size) {
+          return lib.Library::Compress(data, data_size, output, output_size);
+        });
+  }
+
+  void GetDecompressedDataSize(const char *const compressed_data,
+                               const uint64_t &compressed_data_size,
+                               uint64_t *decompressed_data_size) {
+    lib.Library::GetDecompressedDataSize(compressed_data, compressed_data_size,
+                                         decompressed_data_size);
+  }
+
+  bool Decompress(const char *const compressed_data,
+                  const uint64_t &compressed_data_size, char *decompressed_data,
+                  uint64_t *decompressed_data_size) {
+    return DecompressFiltered(
+        decompressed_data, decompressed_data_size,
+        [&](char *output, uint64_t *output_size) {
+          return lib.Library::Decompress(compressed_data, compressed_data_size,
+                                         output, output_size);
+        });
+  }
+
+  bool CompressAgainst(const char *const reference_data,
+                       const uint64_t &reference_data_size,
+                       const char *const uncompressed_data,
+                       const uint64_t &uncompressed_data_size,
+                       char *compressed_data, uint64_t *compressed_data_size) {
+    return CompressAgainstFiltered(
+        reference_data, reference_data_size, uncompressed_data,
+        uncompressed_data_size, compressed_data, compressed_data_size,
+        [this](const char *const reference, const uint64_t &reference_size,
+               const char *const data, const uint64_t &data_size,
+               char *output, uint64_t *output_size) {
+          return lib.Library::CompressAgainst(reference, reference_size, data,
+                                              data_size, output, output_size);
+        });
+  }
+
+  bool DecompressAgainst(const char *const reference_data,
+                         const uint64_t &reference_data_size,
+                         const char *const compressed_data,
+                         const uint64_t &compressed_data_size,
+                         char *decompressed_data,
+                         uint64_t *decompressed_data_size) {
+    return DecompressAgainstFiltered(
+        reference_data, reference_data_size, decompressed_data,
+        decompressed_data_size,
+        [&](const char *const reference, const uint64_t &reference_size,
+            char *output, uint64_t *output_size) {
+          return lib.Library::DecompressAgainst(
+              reference, reference_size, compressed_data,
+              compressed_data_size, output, output_size);
+        });
+  }
+
+  bool Sink(const char *const data, const uint64_t &data_size,
+            uint64_t *sunk_data_size) {
+    return CheckSink(sunk_data_size) &&
+           lib.Library::Sink(data, data_size, sunk_data_size);
+  }
+
+  bool Poll(char *data, uint64_t *data_size, bool *more_data) {
+    return lib.Library::Poll(data, data_size, more_data);
+  }
+
+  bool Finish(bool *finished) { return lib.Library::Finish(finished); }
+
+  void GetTitle() { lib.Library::GetTitle(); }
+
+  bool CompareData(const char *const uncompressed_data,
+                   const uint64_t &uncompressed_data_size,
+                   const char *const decompressed_data,
+                   const uint64_t &decompressed_data_size) {
+    return lib.CompareData(uncompressed_data, uncompressed_data_size,
+                           decompressed_data, decompressed_data_size);
+  }
+
+  bool GetCompressionLevelInformation(
+      std::vector<std::string> *compression_level_information = nullptr,
+      uint8_t *minimum_level = nullptr, uint8_t *maximum_level = nullptr) {
+    return lib.Library::GetCompressionLevelInformation(
+        compression_level_information, minimum_level, maximum_level);
+  }
+
+  bool GetWindowSizeInformation(
+      std::vector<std::string> *window_size_information = nullptr,
+      uint32_t *minimum_size = nullptr, uint32_t *maximum_size = nullptr) {
+    return lib.Library::GetWindowSizeInformation(window_size_information,
+                                                 minimum_size, maximum_size);
+  }
+
+  bool GetModeInformation(std::vector<std::string> *mode_information = nullptr,
+                          uint8_t *minimum_mode = nullptr,
+                          uint8_t *maximum_mode = nullptr,
+                          const uint8_t &compression_level = 0) {
+    return lib.Library::GetModeInformation(mode_information, minimum_mode,
+                                           maximum_mode, compression_level);
+  }
+
+  bool GetWorkFactorInformation(
+      std::vector<std::string> *work_factor_information = nullptr,
+      uint8_t *minimum_factor = nullptr, uint8_t *maximum_factor = nullptr) {
+    return lib.Library::GetWorkFactorInformation(
+        work_factor_information, minimum_factor, maximum_factor);
+  }
+
+  bool GetFlagsInformation(
+      std::vector<std::string> *flags_information = nullptr,
+      uint8_t *minimum_flags = nullptr, uint8_t *maximum_flags = nullptr) {
+    return lib.Library::GetFlagsInformation(flags_information, minimum_flags,
+                                            maximum_flags);
+  }
+
+  bool GetNumberThreadsInformation(
+      std::vector<std::string> *number_threads_information = nullptr,
+      uint8_t *minimum_threads = nullptr, uint8_t *maximum_threads = nullptr) {
+    return lib.Library::GetNumberThreadsInformation(
+        number_threads_information, minimum_threads, maximum_threads);
+  }
+
+  bool GetBackReferenceInformation(
+      std::vector<std::string> *back_reference_information = nullptr,
+      uint8_t *minimum_back_reference = nullptr,
+      uint8_t *maximum_back_reference = nullptr) {
+    return lib.Library::GetBackReferenceInformation(back_reference_information,
+                                                    minimum_back_reference,
+                                                    maximum_back_reference);
+  }
+
+  bool GetFilterInformation(
+      std::vector<std::string> *filter_information = nullptr,
+      uint8_t *minimum_filter = nullptr, uint8_t *maximum_filter = nullptr) {
+    return filter_.GetFilterInformation(filter_information, minimum_filter,
+                                        maximum_filter);
+  }
+
+  bool GetElementSizeInformation(
+      std::vector<std::string> *element_size_information = nullptr,
+      uint8_t *minimum_size = nullptr, uint8_t *maximum_size = nullptr) {
+    return filter_.GetElementSizeInformation(element_size_information,
+                                             minimum_size, maximum_size);
+  }
+
+  std::string GetModeName(const uint8_t &mode) {
+    return lib.Library::GetModeName(mode);
+  }
+
+  std::string GetFlagsName(const uint8_t &flags) {
+    return lib.Library::GetFlagsName(flags);
+  }
+
+  std::string GetFilterName(const uint8_t &filter) {
+    return filter_.GetFilterName(filter);
+  }
+
+  CpuOptions GetOptions() { return lib.Library::GetOptions(); }
+
+  // The name of the library in CpuCompressionLibraries (e.g., "lz4"), which
+  // also names it in the cache
+  explicit CpuSmashT(const std::string &compression_library_name)
+      : CpuSmashCommon(compression_library_name) {
+    static_assert(CpuSmashApi<CpuSmashT>::value, "CpuSmashT API");
+    CheckLibraryName(typeid(Library));
+  }
+};
@@ -0,0 +1,29 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Process-wide limit of the threads created by the compression libraries.
+// The calling thread is not counted, it always works
+class CpuThreadBudget {
+ public:
+  // 0 removes the limit. By default, the number of hardware threads
+  static void SetMaximumThreads(const uint32_t &maximum_threads);
+
+  static uint32_t GetMaximumThreads();
+
+  static uint32_t GetUsedThreads();
+
+  // Returns the threads that can be used (calling thread included), between 1
+  // and number_threads. They must be given back with ReleaseThreads
+  static uint32_t AcquireThreads(const uint32_t &number_threads);
+
+  static void ReleaseThreads(const uint32_t &number_threads);
+};
@@ -0,0 +1,30 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// Process-wide work-stealing pool used by the parallel work of CPU-Smash.
+// Every thread has its own queue and takes tasks from the others when it is
+// empty. Threads are created on first use
+class CpuThreadPool {
+ public:
+  // Must not be called while tasks are running. By default, the number of
+  // hardware threads and no pinning
+  static void SetNumberThreads(const uint32_t &number_threads,
+                               const bool &pin_threads = false);
+
+  static uint32_t GetNumberThreads();
+
+  static void Submit(const std::function<void()> &task);
+
+  // Runs a pending task in the calling thread, if there is any
+  static bool RunPendingTask();
+};
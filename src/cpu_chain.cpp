@@ -0,0 +1,368 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_chain.hpp>
+#include <cpu_compression_libraries.hpp>
+
+// Format: length of the chain (1 byte), the chain and the size of the input
+// of every stage (8 bytes each), followed by the output of the last stage
+
+namespace {
+
+// Names of the filters in a chain, followed by the element size (e.g.,
+// "shuffle4"). The position is the filter in CpuOptions
+const char *const filter_names[] = {"",    "shuffle", "bitshuffle",
+                                    "xor", "delta",   "dod"};
+
+// Short names of libraries with a mode
+const struct {
+  const char *name;
+  const char *library;
+  uint8_t mode;
+} aliases[] = {{"huf", "fse", 1}};
+
+void DeleteStages(std::vector<CpuChainStage> *stages) {
+  for (auto &stage : *stages) {
+    delete stage.filter;
+    delete stage.library;
+  }
+  stages->clear();
+}
+
+}  // namespace
+
+bool CpuChain::ParseStage(const std::string &stage_name,
+                          CpuChainStage *stage) {
+  stage->filter = nullptr;
+  stage->library = nullptr;
+  stage->mode = 0;
+  stage->mode_set = false;
+  bool result{false};
+  // Filters
+  size_t digits = stage_name.find_first_of("0123456789");
+  std::string name = stage_name.substr(0, digits);
+  for (uint8_t filter = 1;
+       !result && filter < sizeof(filter_names) / sizeof(*filter_names);
+       ++filter) {
+    if (name == filter_names[filter]) {
+      CpuOptions options;
+      options.SetFilter(filter);
+      if (digits != std::string::npos) {
+        int element_size = atoi(stage_name.substr(digits).c_str());
+        if (element_size < 1 || element_size > 255) return false;
+        options.SetElementSize(static_cast<uint8_t>(element_size));
+      }
+      stage->filter = new CpuFilter();
+      result = stage->filter->SetOptions(&options);
+      if (!result) {
+        delete stage->filter;
+        stage->filter = nullptr;
+        return false;
+      }
+    }
+  }
+  // Compression libraries, as "name", "name:mode", "name(arguments)" or
+  // "name(arguments):mode"
+  if (!result) {
+    std::string arguments;
+    size_t close = stage_name.rfind(')');
+    size_t separator = stage_name.find(
+        ':', (close == std::string::npos) ? 0 : close);
+    name = stage_name.substr(0, separator);
+    if (separator != std::string::npos) {
+      stage->mode = static_cast<uint8_t>(
+          atoi(stage_name.substr(separator + 1).c_str()));
+      stage->mode_set = true;
+    }
+    size_t open = name.find('(');
+    if (open != std::string::npos) {
+      if (name.back() != ')') return false;
+      arguments = name.substr(open + 1, name.size() - open - 2);
+      name = name.substr(0, open);
+    }
+    for (const auto &alias : aliases) {
+      if (!stage->mode_set && name == alias.name) {
+        name = alias.library;
+        stage->mode = alias.mode;
+        stage->mode_set = true;
+      }
+    }
+    CpuCompressionLibraries libraries;
+    uint16_t library_id;
+    result = !name.empty() && libraries.GetLibraryId(name, &library_id);
+    if (result) {
+      stage->library = libraries.GetCompressionLibrary(library_id);
+      result = stage->library->SetArguments(arguments);
+      if (!result) {
+        delete stage->library;
+        stage->library = nullptr;
+      }
+    }
+  }
+  return result;
+}
+
+// The current chain is kept if the new one is not valid
+bool CpuChain::Parse(const std::string &chain) {
+  std::vector<CpuChainStage> stages;
+  bool result{!chain.empty() && chain.size() < 256};
+  for (size_t begin = 0; result && begin <= chain.size();) {
+    size_t end = chain.find('|', begin);
+    if (end == std::string::npos) end = chain.size();
+    CpuChainStage stage;
+    result = ParseStage(chain.substr(begin, end - begin), &stage);
+    if (result) {
+      stages.push_back(stage);
+    } else {
+      std::cout << "ERROR: The stage " << chain.substr(begin, end - begin)
+                << " of the chain does not exist" << std::endl;
+    }
+    begin = end + 1;
+  }
+  if (result) {
+    Clear();
+    stages_.swap(stages);
+    chain_ = chain;
+  } else {
+    DeleteStages(&stages);
+  }
+  return result;
+}
+
+void CpuChain::Clear() {
+  DeleteStages(&stages_);
+  chain_.clear();
+}
+
+bool CpuChain::SetOptionsStages(const bool &compressor) {
+  // The level, window and threads options are for every library of the chain
+  bool result{true};
+  for (auto &stage : stages_) {
+    if (stage.library) {
+      CpuOptions options;
+      if (options_.CompressionLevelIsSet()) {
+        options.SetCompressionLevel(options_.GetCompressionLevel());
+      }
+      if (options_.WindowSizeIsSet()) {
+        options.SetWindowSize(options_.GetWindowSize());
+      }
+      if (options_.NumberThreadsIsSet()) {
+        options.SetNumberThreads(options_.GetNumberThreads());
+      }
+      if (stage.mode_set) options.SetMode(stage.mode);
+      result = compressor ? stage.library->SetOptionsCompressor(&options)
+                          : stage.library->SetOptionsDecompressor(&options);
+      if (!result) break;
+    }
+  }
+  return result;
+}
+
+bool CpuChain::SetOptionsCompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsCompressor(options)};
+  if (result) initialized_compressor_ = result = SetOptionsStages(true);
+  return result;
+}
+
+bool CpuChain::SetOptionsDecompressor(CpuOptions *options) {
+  bool result{CpuCompressionLibrary::SetOptionsDecompressor(options)};
+  if (result) initialized_decompressor_ = result = SetOptionsStages(false);
+  return result;
+}
+
+uint64_t CpuChain::GetHeaderSize() {
+  return 1 + chain_.size() + stages_.size() * sizeof(uint64_t);
+}
+
+char *CpuChain::GetBuffer(const char *const data, const uint64_t &size) {
+  // The intermediate buffers are reused, taking the one without the data
+  std::vector<char> *buffer = &buffers_[data == buffers_[0].data() ? 1 : 0];
+  if (buffer->size() < size) buffer->resize(size);
+  return buffer->data();
+}
+
+void CpuChain::GetCompressedDataSize(const char *const uncompressed_data,
+                                     const uint64_t &uncompressed_data_size,
+                                     uint64_t *compressed_data_size) {
+  // Only the first stage sees the data, so the libraries are given the size
+  *compressed_data_size = uncompressed_data_size;
+  for (auto &stage : stages_) {
+    if (stage.library) {
+      stage.library->GetCompressedDataSize(nullptr, *compressed_data_size,
+                                           compressed_data_size);
+    }
+  }
+  *compressed_data_size += GetHeaderSize();
+}
+
+bool CpuChain::Compress(const char *const uncompressed_data,
+                        const uint64_t &uncompressed_data_size,
+                        char *compressed_data, uint64_t *compressed_data_size) {
+  const uint64_t header_size = GetHeaderSize();
+  bool result{initialized_compressor_ && header_size <= *compressed_data_size};
+  if (result) {
+    uint64_t last_library{stages_.size()};
+    for (uint64_t i = 0; i < stages_.size(); ++i) {
+      if (stages_[i].library) last_library = i;
+    }
+    char *output = compressed_data + header_size;
+    const char *data = uncompressed_data;
+    uint64_t size = uncompressed_data_size;
+    for (uint64_t i = 0; result && i < stages_.size(); ++i) {
+      memcpy(compressed_data + 1 + chain_.size() + i * sizeof(uint64_t), &size,
+             sizeof(size));
+      if (stages_[i].filter) {
+        data = stages_[i].filter->Apply(data, size);
+      } else {
+        // The last library writes the final result
+        char *stage_output = output;
+        uint64_t stage_size = *compressed_data_size - header_size;
+        if (i != last_library) {
+          stages_[i].library->GetCompressedDataSize(nullptr, size,
+                                                    &stage_size);
+          stage_output = GetBuffer(data, stage_size);
+        }
+        result = stages_[i].library->Compress(data, size, stage_output,
+                                              &stage_size);
+        data = stage_output;
+        size = stage_size;
+      }
+    }
+    if (result && data != output) {
+      // There are only filters after the last library
+      result = size <= *compressed_data_size - header_size;
+      if (result && size) memcpy(output, data, size);
+    }
+    if (result) {
+      compressed_data[0] = static_cast<char>(chain_.size());
+      memcpy(compressed_data + 1, chain_.data(), chain_.size());
+      *compressed_data_size = header_size + size;
+    } else {
+      std::cout << "ERROR: chain error when compress data" << std::endl;
+    }
+  }
+  return result;
+}
+
+void CpuChain::GetDecompressedDataSize(const char *const compressed_data,
+                                       const uint64_t &compressed_data_size,
+                                       uint64_t *decompressed_data_size) {
+  *decompressed_data_size = 0;
+  if (compressed_data_size > 0) {
+    // The input of the first stage
+    const uint64_t position = 1 + static_cast<uint8_t>(compressed_data[0]);
+    if (position + sizeof(uint64_t) <= compressed_data_size) {
+      memcpy(decompressed_data_size, compressed_data + position,
+             sizeof(uint64_t));
+    }
+  }
+}
+
+bool CpuChain::Decompress(const char *const compressed_data,
+                          const uint64_t &compressed_data_size,
+                          char *decompressed_data,
+                          uint64_t *decompressed_data_size) {
+  bool result{initialized_decompressor_ && compressed_data_size > 0};
+  if (result) {
+    // The chain of the data is used, replacing the current one if needed
+    const uint64_t chain_size = static_cast<uint8_t>(compressed_data[0]);
+    result = 1 + chain_size <= compressed_data_size;
+    if (result) {
+      std::string chain(compressed_data + 1, chain_size);
+      if (chain != chain_) {
+        result = Parse(chain);
+        // The stages of a valid chain without options are not kept
+        if (result && !SetOptionsStages(false)) {
+          Clear();
+          result = false;
+        }
+      }
+      result = result && !stages_.empty();
+    }
+  }
+  if (result) {
+    const uint64_t header_size = GetHeaderSize();
+    result = header_size <= compressed_data_size;
+    std::vector<uint64_t> sizes(stages_.size());
+    if (result) {
+      memcpy(sizes.data(), compressed_data + 1 + chain_.size(),
+             sizes.size() * sizeof(uint64_t));
+      result = sizes[0] <= *decompressed_data_size;
+    }
+    // The size of every stage can not be higher than its worst case
+    for (uint64_t i = 1; result && i < stages_.size(); ++i) {
+      uint64_t size = sizes[i - 1];
+      if (stages_[i - 1].library) {
+        stages_[i - 1].library->GetCompressedDataSize(nullptr, sizes[i - 1],
+                                                      &size);
+      }
+      result = sizes[i] <= size;
+    }
+    uint64_t first_library{stages_.size()};
+    for (uint64_t i = stages_.size(); i-- > 0;) {
+      if (stages_[i].library) first_library = i;
+    }
+    // The first library writes the final result, and the filters before it
+    // are reverted there
+    const char *data = compressed_data + header_size;
+    uint64_t size = compressed_data_size - header_size;
+    for (uint64_t i = stages_.size(); result && i-- > 0;) {
+      char *output = decompressed_data;
+      if (stages_[i].filter && data != compressed_data + header_size) {
+        // The filters are reverted in place out of the compressed data
+        output = const_cast<char *>(data);
+      } else if (i > first_library) {
+        output = GetBuffer(data, sizes[i]);
+      }
+      if (stages_[i].library) {
+        uint64_t stage_size = sizes[i];
+        result = stages_[i].library->Decompress(data, size, output,
+                                                &stage_size) &&
+                 stage_size == sizes[i];
+        size = stage_size;
+      } else {
+        result = size == sizes[i];
+        if (result && size && data != output) memcpy(output, data, size);
+        if (result) stages_[i].filter->Revert(output, size);
+      }
+      data = output;
+    }
+    if (result) {
+      *decompressed_data_size = sizes[0];
+    } else {
+      std::cout << "ERROR: chain error when decompress data" << std::endl;
+    }
+  }
+  return result;
+}
+
+void CpuChain::GetTitle() {
+  CpuCompressionLibrary::GetTitle("chain", "Runs the stages " + chain_ +
+                                               " one after the other");
+}
+
+bool CpuChain::IsStateless() {
+  bool result{true};
+  for (const auto &stage : stages_) {
+    if (stage.library && !stage.library->IsStateless()) result = false;
+  }
+  return result;
+}
+
+// The filters of the chain are given by its stages
+CpuChain::CpuChain(const std::string &chain) {
+  if (!Parse(chain)) {
+    std::cout << "ERROR: The chain " << chain << " is not valid" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+CpuChain::~CpuChain() { Clear(); }
@@ -0,0 +1,169 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_cache.hpp>
+
+namespace {
+
+struct CacheEntry {
+  uint64_t hash;
+  std::string key;
+  // The data is compared, so a collision of the hashes is not a hit
+  std::vector<char> data;
+  std::vector<char> compressed_data;
+};
+
+// The most recently used entries are at the front
+std::list<CacheEntry> cache_entries;
+std::unordered_multimap<uint64_t, std::list<CacheEntry>::iterator>
+    cache_positions;
+std::mutex cache_mutex;
+uint64_t cache_maximum_size{0};
+uint64_t cache_used_size{0};
+uint64_t cache_hits{0};
+uint64_t cache_misses{0};
+
+uint64_t GetEntrySize(const CacheEntry &entry) {
+  return entry.data.size() + entry.compressed_data.size();
+}
+
+// Removes the least recently used entries until the cache fits
+void Shrink(const uint64_t &maximum_size) {
+  while (cache_used_size > maximum_size) {
+    const CacheEntry &entry = cache_entries.back();
+    auto range = cache_positions.equal_range(entry.hash);
+    for (auto position = range.first; position != range.second; ++position) {
+      if (&*position->second == &entry) {
+        cache_positions.erase(position);
+        break;
+      }
+    }
+    cache_used_size -= GetEntrySize(entry);
+    cache_entries.pop_back();
+  }
+}
+
+void AppendValue(const bool &value_set, const uint64_t &value,
+                 std::string *key) {
+  const uint64_t stored_value = value_set ? value : 0;
+  key->push_back(value_set ? 1 : 0);
+  key->append(reinterpret_cast<const char *>(&stored_value),
+              sizeof(stored_value));
+}
+
+}  // namespace
+
+void CpuCompressionCache::SetMaximumSize(const uint64_t &maximum_size) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache_maximum_size = maximum_size;
+  Shrink(maximum_size);
+}
+
+uint64_t CpuCompressionCache::GetMaximumSize() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache_maximum_size;
+}
+
+uint64_t CpuCompressionCache::GetUsedSize() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache_used_size;
+}
+
+uint64_t CpuCompressionCache::GetHits() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache_hits;
+}
+
+uint64_t CpuCompressionCache::GetMisses() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache_misses;
+}
+
+void CpuCompressionCache::Clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  Shrink(0);
+  cache_hits = 0;
+  cache_misses = 0;
+}
+
+std::string CpuCompressionCache::GetKey(const std::string &library_name,
+                                        const CpuOptions &options) {
+  std::string result{library_name};
+  result.push_back('\0');
+  AppendValue(options.CompressionLevelIsSet(), options.GetCompressionLevel(),
+              &result);
+  AppendValue(options.WindowSizeIsSet(), options.GetWindowSize(), &result);
+  AppendValue(options.ModeIsSet(), options.GetMode(), &result);
+  AppendValue(options.WorkFactorIsSet(), options.GetWorkFactor(), &result);
+  AppendValue(options.FlagsIsSet(), options.GetFlags(), &result);
+  AppendValue(options.NumberThreadsIsSet(), options.GetNumberThreads(),
+              &result);
+  AppendValue(options.BackReferenceIsSet(), options.GetBackReference(),
+              &result);
+  AppendValue(options.FilterIsSet(), options.GetFilter(), &result);
+  AppendValue(options.ElementSizeIsSet(), options.GetElementSize(), &result);
+  AppendValue(options.DataTypeIsSet(), options.GetDataType(), &result);
+  const std::vector<uint64_t> shape = options.GetShape();
+  AppendValue(options.ShapeIsSet(), shape.size(), &result);
+  for (const auto &dimension : shape) AppendValue(true, dimension, &result);
+  return result;
+}
+
+bool CpuCompressionCache::Find(const uint64_t &hash, const std::string &key,
+                               const char *const data,
+                               const uint64_t &data_size,
+                               char *compressed_data,
+                               uint64_t *compressed_data_size) {
+  bool result{false};
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto range = cache_positions.equal_range(hash);
+  for (auto position = range.first; !result && position != range.second;
+       ++position) {
+    const CacheEntry &entry = *position->second;
+    result = entry.key == key && entry.data.size() == data_size &&
+             entry.compressed_data.size() <= *compressed_data_size &&
+             memcmp(entry.data.data(), data, data_size) == 0;
+    if (result) {
+      memcpy(compressed_data, entry.compressed_data.data(),
+             entry.compressed_data.size());
+      *compressed_data_size = entry.compressed_data.size();
+      cache_entries.splice(cache_entries.begin(), cache_entries,
+                           position->second);
+    }
+  }
+  if (result) {
+    ++cache_hits;
+  } else {
+    ++cache_misses;
+  }
+  return result;
+}
+
+void CpuCompressionCache::Add(const uint64_t &hash, const std::string &key,
+                              const char *const data, const uint64_t &data_size,
+                              const char *const compressed_data,
+                              const uint64_t &compressed_data_size) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (data_size + compressed_data_size <= cache_maximum_size) {
+    cache_entries.push_front(CacheEntry{
+        hash, key, std::vector<char>(data, data + data_size),
+        std::vector<char>(compressed_data,
+                          compressed_data + compressed_data_size)});
+    cache_positions.emplace(hash, cache_entries.begin());
+    cache_used_size += data_size + compressed_data_size;
+    Shrink(cache_maximum_size);
+  }
+}
@@ -6,10 +6,19 @@
  * Universidad Politécnica de Valencia (Spain)
  */
 
+#ifdef CPU_SMASH_PLUGINS
+#include <dlfcn.h>
+#endif  // CPU_SMASH_PLUGINS
+
+#include <algorithm>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 
 // CPU-SMASH LIBRARIES
+#include <cpu_compression_libraries.hpp>
+#ifndef CPU_SMASH_PLUGINS
 #ifdef BRIEFLZ
 #include <brieflz_library.hpp>
 #endif  // BRIEFLZ
@@ -22,7 +31,6 @@
 #ifdef CBLOSC2
 #include <c-blosc2_library.hpp>
 #endif  // CBLOSC2
-#include <cpu_compression_libraries.hpp>
 #ifdef CSC
 #include <csc_library.hpp>
 #endif  // CSC
@@ -95,6 +103,9 @@
 #ifdef PITHY
 #include <pithy_library.hpp>
 #endif  // PITHY
+#ifdef PLANES
+#include <planes_library.hpp>
+#endif  // PLANES
 #ifdef QUICKLZ
 #include <quicklz_library.hpp>
 #endif  // QUICKLZ
@@ -116,6 +127,9 @@
 #ifdef Z3LIB
 #include <z3lib_library.hpp>
 #endif  // Z3LIB
+#ifdef ZERO
+#include <zero_library.hpp>
+#endif  // ZERO
 #ifdef ZLIB_NG
 #include <zlib-ng_library.hpp>
 #endif  // ZLIB_NG
@@ -136,163 +150,321 @@
 #include <lzsse_library.hpp>
 #endif  // LZSSE
 #endif  // __x86_64__
+#endif  // CPU_SMASH_PLUGINS
 
-CpuCompressionLibrary *CpuCompressionLibraries::GetCompressionLibrary(
-    const std::string &library_name) {
-  auto lib = map_.find(library_name);
-  if (lib == map_.end()) {
-    std::cout << "ERROR: The compression library does not exist" << std::endl;
-    exit(EXIT_FAILURE);
-  }
-  return lib->second();
-}
+namespace {
 
-void CpuCompressionLibraries::GetListInformation() {
-  CpuCompressionLibrary *library;
-  int i = 0;
-  for (auto &lib : map_) {
-    library = lib.second();
-    std::cout << std::right << std::setw(3) << std::setfill(' ') << ++i << ": ";
-    library->GetTitle();
-    delete library;
-  }
-}
+#ifdef CPU_SMASH_PLUGINS
+// The libraries are plugins, loaded when they are used for first time
+#define CREATE_LIBRARY(library) nullptr
+#else
+#define CREATE_LIBRARY(library) Create<library>
 
-std::vector<std::string> CpuCompressionLibraries::GetNameLibraries() {
-  std::vector<std::string> result;
-  for (auto &lib : map_) {
-    result.push_back(lib.first);
-  }
-  return result;
+template <class Library>
+CpuCompressionLibrary *Create() {
+  return new Library();
 }
+#endif  // CPU_SMASH_PLUGINS
 
-CpuCompressionLibraries::CpuCompressionLibraries() {
+struct CpuCompressionLibraryEntry {
+  const char *name;
+  CpuCompressionLibrary *(*create)();
+};
+
+// Sorted by name, the identifier of a library is its position in the table
+constexpr CpuCompressionLibraryEntry libraries[] = {
 #ifdef BRIEFLZ
-  map_["brieflz"] = []() { return new BrieflzLibrary(); };
+    {"brieflz", CREATE_LIBRARY(BrieflzLibrary)},
 #endif  // BRIEFLZ
 #ifdef BROTLI
-  map_["brotli"] = []() { return new BrotliLibrary(); };
+    {"brotli", CREATE_LIBRARY(BrotliLibrary)},
 #endif  // BROTLI
 #ifdef BZIP2
-  map_["bzip2"] = []() { return new Bzip2Library(); };
+    {"bzip2", CREATE_LIBRARY(Bzip2Library)},
 #endif  // BZIP2
 #ifdef CBLOSC2
-  map_["c-blosc2"] = []() { return new CBlosc2Library(); };
+    {"c-blosc2", CREATE_LIBRARY(CBlosc2Library)},
 #endif  // CBLOSC2
 #ifdef CSC
-  map_["csc"] = []() { return new CscLibrary(); };
+    {"csc", CREATE_LIBRARY(CscLibrary)},
 #endif  // CSC
 #ifdef DENSITY
-  map_["density"] = []() { return new DensityLibrary(); };
+    {"density", CREATE_LIBRARY(DensityLibrary)},
 #endif  // DENSITY
 #ifdef FLZ
-  map_["flz"] = []() { return new FlzLibrary(); };
+    {"flz", CREATE_LIBRARY(FlzLibrary)},
 #endif  // FLZ
 #ifdef FLZMA2
-  map_["flzma2"] = []() { return new Flzma2Library(); };
+    {"flzma2", CREATE_LIBRARY(Flzma2Library)},
 #endif  // FLZMA2
 #ifdef FSE
-  map_["fse"] = []() { return new FseLibrary(); };
+    {"fse", CREATE_LIBRARY(FseLibrary)},
 #endif  // FSE
 #ifdef GIPFELI
-  map_["gipfeli"] = []() { return new GipfeliLibrary(); };
+    {"gipfeli", CREATE_LIBRARY(GipfeliLibrary)},
 #endif  // GIPFELI
 #ifdef HEATSHRINK
-  map_["heatshrink"] = []() { return new HeatshrinkLibrary(); };
+    {"heatshrink", CREATE_LIBRARY(HeatshrinkLibrary)},
 #endif  // HEATSHRINK
 #ifdef LIBBSC
-  map_["libbsc"] = []() { return new LibbscLibrary(); };
+    {"libbsc", CREATE_LIBRARY(LibbscLibrary)},
 #endif  // LIBBSC
 #ifdef LIBDEFLATE
-  map_["libdeflate"] = []() { return new LibdeflateLibrary(); };
+    {"libdeflate", CREATE_LIBRARY(LibdeflateLibrary)},
 #endif  // LIBDEFLATE
 #ifdef LIBLZG
-  map_["liblzg"] = []() { return new LiblzgLibrary(); };
+    {"liblzg", CREATE_LIBRARY(LiblzgLibrary)},
 #endif  // LIBLZG
 #ifdef LIZARD
-  map_["lizard"] = []() { return new LizardLibrary(); };
+    {"lizard", CREATE_LIBRARY(LizardLibrary)},
 #endif  // LIZARD
 #ifdef LODEPNG
-  map_["lodepng"] = []() { return new LodepngLibrary(); };
+    {"lodepng", CREATE_LIBRARY(LodepngLibrary)},
 #endif  // LODEPNG
 #ifdef LZ4
-  map_["lz4"] = []() { return new Lz4Library(); };
+    {"lz4", CREATE_LIBRARY(Lz4Library)},
 #endif  // LZ4
 #ifdef LZF
-  map_["lzf"] = []() { return new LzfLibrary(); };
+    {"lzf", CREATE_LIBRARY(LzfLibrary)},
 #endif  // LZF
 #ifdef LZFSE
-  map_["lzfse"] = []() { return new LzfseLibrary(); };
+    {"lzfse", CREATE_LIBRARY(LzfseLibrary)},
 #endif  // LZFSE
 #ifdef LZFX
-  map_["lzfx"] = []() { return new LzfxLibrary(); };
+    {"lzfx", CREATE_LIBRARY(LzfxLibrary)},
 #endif  // LZFX
 #ifdef LZHAM
-  map_["lzham"] = []() { return new LzhamLibrary(); };
+    {"lzham", CREATE_LIBRARY(LzhamLibrary)},
 #endif  // LZHAM
 #ifdef LZJB
-  map_["lzjb"] = []() { return new LzjbLibrary(); };
+    {"lzjb", CREATE_LIBRARY(LzjbLibrary)},
 #endif  // LZJB
 #ifdef LZMA
-  map_["lzma"] = []() { return new LzmaLibrary(); };
+    {"lzma", CREATE_LIBRARY(LzmaLibrary)},
 #endif  // LZMA
 #ifdef LZMAT
-  map_["lzmat"] = []() { return new LzmatLibrary(); };
+    {"lzmat", CREATE_LIBRARY(LzmatLibrary)},
 #endif  // LZMAT
 #ifdef LZO
-  map_["lzo"] = []() { return new LzoLibrary(); };
+    {"lzo", CREATE_LIBRARY(LzoLibrary)},
 #endif  // LZO
+#ifdef __x86_64__
+#ifdef LZSSE
+    {"lzsse", CREATE_LIBRARY(LzsseLibrary)},
+#endif  // LZSSE
+#endif  // __x86_64__
 #ifdef MINIZ
-  map_["miniz"] = []() { return new MinizLibrary(); };
+    {"miniz", CREATE_LIBRARY(MinizLibrary)},
 #endif  // MINIZ
 #ifdef MS
-  map_["ms"] = []() { return new MsLibrary(); };
+    {"ms", CREATE_LIBRARY(MsLibrary)},
 #endif  // MS
 #ifdef PITHY
-  map_["pithy"] = []() { return new PithyLibrary(); };
+    {"pithy", CREATE_LIBRARY(PithyLibrary)},
 #endif  // PITHY
+#ifdef PLANES
+    {"planes", CREATE_LIBRARY(PlanesLibrary)},
+#endif  // PLANES
 #ifdef QUICKLZ
-  map_["quicklz"] = []() { return new QuicklzLibrary(); };
+    {"quicklz", CREATE_LIBRARY(QuicklzLibrary)},
 #endif  // QUICKLZ
 #ifdef SNAPPY
-  map_["snappy"] = []() { return new SnappyLibrary(); };
+    {"snappy", CREATE_LIBRARY(SnappyLibrary)},
 #endif  // SNAPPY
 #ifdef UCL
-  map_["ucl"] = []() { return new UclLibrary(); };
+    {"ucl", CREATE_LIBRARY(UclLibrary)},
 #endif  // UCL
 #ifdef WFLZ
-  map_["wflz"] = []() { return new WflzLibrary(); };
+    {"wflz", CREATE_LIBRARY(WflzLibrary)},
 #endif  // WFLZ
 #ifdef XPACK
-  map_["xpack"] = []() { return new XpackLibrary(); };
+    {"xpack", CREATE_LIBRARY(XpackLibrary)},
 #endif  // XPACK
 #ifdef YALZ77
-  map_["yalz77"] = []() { return new Yalz77Library(); };
+    {"yalz77", CREATE_LIBRARY(Yalz77Library)},
 #endif  // YALZ77
 #ifdef Z3LIB
-  map_["z3lib"] = []() { return new Z3libLibrary(); };
+    {"z3lib", CREATE_LIBRARY(Z3libLibrary)},
 #endif  // Z3LIB
+#ifdef ZERO
+    {"zero", CREATE_LIBRARY(ZeroLibrary)},
+#endif  // ZERO
 #ifdef ZLIB
-  map_["zlib"] = []() { return new ZlibLibrary(); };
+    {"zlib", CREATE_LIBRARY(ZlibLibrary)},
 #endif  // ZLIB
 #ifdef ZLIB_NG
-  map_["zlib-ng"] = []() { return new ZlibNgLibrary(); };
+    {"zlib-ng", CREATE_LIBRARY(ZlibNgLibrary)},
 #endif  // ZLIB_NG
 #ifdef ZLING
-  map_["zling"] = []() { return new ZlingLibrary(); };
+    {"zling", CREATE_LIBRARY(ZlingLibrary)},
 #endif  // ZLING
 #ifdef ZPAQ
-  map_["zpaq"] = []() { return new ZpaqLibrary(); };
+    {"zpaq", CREATE_LIBRARY(ZpaqLibrary)},
 #endif  // ZPAQ
 #ifdef ZSTD
-  map_["zstd"] = []() { return new ZstdLibrary(); };
+    {"zstd", CREATE_LIBRARY(ZstdLibrary)},
 #endif  // ZSTD
+};
 
-#ifdef __x86_64__
-#ifdef LZSSE
-  map_["lzsse"] = []() { return new LzsseLibrary(); };
-#endif  // LZSSE
-#endif  // __x86_64__
+constexpr uint16_t number_libraries =
+    sizeof(libraries) / sizeof(CpuCompressionLibraryEntry);
+
+// As std::string::compare, for the lookup with std::lower_bound
+constexpr bool IsBefore(const char *const name, const char *const next_name) {
+  return (*name == *next_name)
+             ? *name != '\0' && IsBefore(name + 1, next_name + 1)
+             : static_cast<unsigned char>(*name) <
+                   static_cast<unsigned char>(*next_name);
 }
 
+constexpr bool IsSorted(const uint16_t &library_id) {
+  return library_id + 1 >= number_libraries ||
+         (IsBefore(libraries[library_id].name,
+                   libraries[library_id + 1].name) &&
+          IsSorted(library_id + 1));
+}
+
+static_assert(IsSorted(0), "The libraries must be sorted by name");
+
+// Idle instances kept of every library, the rest are deleted when returned
+const uint64_t kMaximumIdleInstances{16};
+
+// Idle instances of each library, they keep their workspaces
+class CpuCompressionLibraryPool {
+ public:
+  std::mutex mutex;
+  std::vector<CpuCompressionLibrary *> instances[number_libraries];
+
+  ~CpuCompressionLibraryPool() {
+    for (auto &library_instances : instances) {
+      for (auto &instance : library_instances) {
+        delete instance;
+      }
+    }
+  }
+};
+
+#ifdef CPU_SMASH_PLUGINS
+CpuCompressionLibrary *(*LoadPlugin(const char *name))() {
+  const char *directory = getenv("CPU_SMASH_PLUGIN_PATH");
+  std::string path = std::string(directory ? directory
+                                           : CPU_SMASH_PLUGIN_DIRECTORY) +
+                     "/libcpu_smash_" + name + ".so";
+  void *plugin = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  void *create{plugin ? dlsym(plugin, "CpuSmashCreateLibrary") : nullptr};
+  if (!create) {
+    std::cout << "ERROR: The compression library can not be loaded ("
+              << dlerror() << ")" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return reinterpret_cast<CpuCompressionLibrary *(*)()>(create);
+}
+#endif  // CPU_SMASH_PLUGINS
+
+CpuCompressionLibrary *CreateLibrary(const uint16_t &library_id) {
+#ifdef CPU_SMASH_PLUGINS
+  // Plugins are never unloaded, their libraries can be alive until exit
+  static std::mutex plugins_mutex;
+  static CpuCompressionLibrary *(*plugins[number_libraries])() = {};
+  std::unique_lock<std::mutex> lock(plugins_mutex);
+  if (!plugins[library_id]) {
+    plugins[library_id] = LoadPlugin(libraries[library_id].name);
+  }
+  lock.unlock();
+  return plugins[library_id]();
+#else
+  return libraries[library_id].create();
+#endif  // CPU_SMASH_PLUGINS
+}
+
+CpuCompressionLibraryPool &GetPool() {
+  static CpuCompressionLibraryPool pool;
+  return pool;
+}
+
+}  // namespace
+
+bool CpuCompressionLibraries::GetLibraryId(const std::string &library_name,
+                                           uint16_t *library_id) {
+  auto entry = std::lower_bound(
+      libraries, libraries + number_libraries, library_name,
+      [](const CpuCompressionLibraryEntry &entry, const std::string &name) {
+        return name.compare(entry.name) > 0;
+      });
+  bool result{entry != libraries + number_libraries &&
+              library_name.compare(entry->name) == 0};
+  if (result) {
+    *library_id = static_cast<uint16_t>(entry - libraries);
+  }
+  return result;
+}
+
+CpuCompressionLibrary *CpuCompressionLibraries::GetCompressionLibrary(
+    const std::string &library_name) {
+  uint16_t library_id{0};
+  if (!GetLibraryId(library_name, &library_id)) {
+    std::cout << "ERROR: The compression library does not exist" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return CreateLibrary(library_id);
+}
+
+CpuCompressionLibrary *CpuCompressionLibraries::GetCompressionLibrary(
+    const uint16_t &library_id) {
+  if (library_id >= number_libraries) {
+    std::cout << "ERROR: The compression library does not exist" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  return CreateLibrary(library_id);
+}
+
+CpuCompressionLibrary *CpuCompressionLibraries::CheckOutCompressionLibrary(
+    const uint16_t &library_id) {
+  CpuCompressionLibrary *library{nullptr};
+  if (library_id < number_libraries) {
+    CpuCompressionLibraryPool &pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.instances[library_id].empty()) {
+      library = pool.instances[library_id].back();
+      pool.instances[library_id].pop_back();
+    }
+  }
+  // Only the workspaces are reused, the options must be set again
+  if (library) library->Reset();
+  return library ? library : GetCompressionLibrary(library_id);
+}
+
+void CpuCompressionLibraries::ReturnCompressionLibrary(
+    const uint16_t &library_id, CpuCompressionLibrary *library) {
+  bool pooled{false};
+  if (library_id < number_libraries) {
+    CpuCompressionLibraryPool &pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pooled = pool.instances[library_id].size() < kMaximumIdleInstances;
+    if (pooled) pool.instances[library_id].push_back(library);
+  }
+  if (!pooled) delete library;
+}
+
+void CpuCompressionLibraries::GetListInformation() {
+  CpuCompressionLibrary *library;
+  for (uint16_t i = 0; i < number_libraries; ++i) {
+    library = CreateLibrary(i);
+    std::cout << std::right << std::setw(3) << std::setfill(' ') << i + 1
+              << ": ";
+    library->GetTitle();
+    delete library;
+  }
+}
+
+std::vector<std::string> CpuCompressionLibraries::GetNameLibraries() {
+  std::vector<std::string> result;
+  for (auto &lib : libraries) {
+    result.push_back(lib.name);
+  }
+  return result;
+}
+
+CpuCompressionLibraries::CpuCompressionLibraries() {}
+
 CpuCompressionLibraries::~CpuCompressionLibraries() {}
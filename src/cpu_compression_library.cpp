@@ -8,10 +8,14 @@
 
 #include <string.h>
 
+#include <condition_variable>
 #include <iomanip>
+#include <mutex>
 
 // CPU-SMASH LIBRARIES
 #include <cpu_compression_library.hpp>
+#include <cpu_thread_budget.hpp>
+#include <cpu_thread_pool.hpp>
 
 bool CpuCompressionLibrary::CheckOptions(CpuOptions *options,
                                          const bool &compressor) {
@@ -49,6 +53,78 @@ void CpuCompressionLibrary::GetDecompressedDataSize(
   // There is no way to obtain with the library
 }
 
+// Output is the XOR of the data with the reference, and the rest of the data
+// when the reference is shorter. Output can be the data
+static void XorReference(const char *const data, const uint64_t &data_size,
+                         const char *const reference_data,
+                         const uint64_t &reference_data_size, char *output) {
+  const uint64_t size =
+      (data_size < reference_data_size) ? data_size : reference_data_size;
+  uint64_t i{0};
+  for (uint64_t word, reference_word; i + sizeof(word) <= size;
+       i += sizeof(word)) {
+    memcpy(&word, data + i, sizeof(word));
+    memcpy(&reference_word, reference_data + i, sizeof(reference_word));
+    word ^= reference_word;
+    memcpy(output + i, &word, sizeof(word));
+  }
+  for (; i < size; ++i) output[i] = data[i] ^ reference_data[i];
+  if (output != data && data_size > size) {
+    memcpy(output + size, data + size, data_size - size);
+  }
+}
+
+bool CpuCompressionLibrary::CompressAgainst(
+    const char *const reference_data, const uint64_t &reference_data_size,
+    const char *const uncompressed_data, const uint64_t &uncompressed_data_size,
+    char *compressed_data, uint64_t *compressed_data_size) {
+  // Libraries without dictionaries compress the XOR with the reference, where
+  // the bytes that did not change are zero
+  if (reference_buffer_.size() < uncompressed_data_size) {
+    reference_buffer_.resize(uncompressed_data_size);
+  }
+  XorReference(uncompressed_data, uncompressed_data_size, reference_data,
+               reference_data_size, reference_buffer_.data());
+  return Compress(reference_buffer_.data(), uncompressed_data_size,
+                  compressed_data, compressed_data_size);
+}
+
+bool CpuCompressionLibrary::DecompressAgainst(
+    const char *const reference_data, const uint64_t &reference_data_size,
+    const char *const compressed_data, const uint64_t &compressed_data_size,
+    char *decompressed_data, uint64_t *decompressed_data_size) {
+  bool result{Decompress(compressed_data, compressed_data_size,
+                         decompressed_data, decompressed_data_size)};
+  if (result) {
+    XorReference(decompressed_data, *decompressed_data_size, reference_data,
+                 reference_data_size, decompressed_data);
+  }
+  return result;
+}
+
+bool CpuCompressionLibrary::Sink(const char *const data,
+                                 const uint64_t &data_size,
+                                 uint64_t *sunk_data_size) {
+  // Only some libraries can work incrementally
+  std::cout << "ERROR: Incremental mode is not available" << std::endl;
+  *sunk_data_size = 0;
+  return false;
+}
+
+bool CpuCompressionLibrary::Poll(char *data, uint64_t *data_size,
+                                 bool *more_data) {
+  std::cout << "ERROR: Incremental mode is not available" << std::endl;
+  *data_size = 0;
+  *more_data = false;
+  return false;
+}
+
+bool CpuCompressionLibrary::Finish(bool *finished) {
+  std::cout << "ERROR: Incremental mode is not available" << std::endl;
+  *finished = false;
+  return false;
+}
+
 void CpuCompressionLibrary::GetTitle(const std::string &library_name,
                                      const std::string &description) {
   std::cout << std::left << std::setw(15) << std::setfill(' ') << library_name
@@ -300,6 +376,70 @@ bool CpuCompressionLibrary::CheckBackReference(
   return result;
 }
 
+void CpuCompressionLibrary::ParallelFor(
+    const uint64_t &number_of_tasks, const uint8_t &number_threads,
+    const std::function<void(const uint64_t &task)> &function) {
+  uint64_t slots = (number_threads < number_of_tasks) ? number_threads
+                                                      : number_of_tasks;
+  // The pool threads that work for this call are taken from the budget. The
+  // slots without a thread run in the granted ones
+  uint32_t jobs = (slots > 1) ? CpuThreadBudget::AcquireThreads(slots) : 1;
+  // Tasks with the same (i % number_threads) always run in the same job, so
+  // the tasks can use per thread resources indexed that way
+  auto job = [&](const uint64_t &first_slot) {
+    for (uint64_t slot = first_slot; slot < slots; slot += jobs) {
+      for (uint64_t task = slot; task < number_of_tasks;
+           task += number_threads) {
+        function(task);
+      }
+    }
+  };
+  if (jobs <= 1) {
+    for (uint64_t task = 0; task < number_of_tasks; ++task) function(task);
+  } else {
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t pending_jobs{jobs - 1};
+    for (uint32_t first_slot = 1; first_slot < jobs; ++first_slot) {
+      CpuThreadPool::Submit([&, first_slot]() {
+        job(first_slot);
+        // Notified while locked, the waiting thread destroys the condition as
+        // soon as there are no pending jobs
+        std::lock_guard<std::mutex> lock(mutex);
+        --pending_jobs;
+        condition.notify_one();
+      });
+    }
+    // The calling thread also works. It helps the pool while there are queued
+    // tasks, so nested calls from pool threads can not deadlock, and sleeps
+    // when the remaining jobs are already running
+    job(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (pending_jobs) {
+      lock.unlock();
+      bool ran_task = CpuThreadPool::RunPendingTask();
+      lock.lock();
+      if (!ran_task) {
+        condition.wait(lock, [&pending_jobs] { return pending_jobs == 0; });
+      }
+    }
+    lock.unlock();
+    CpuThreadBudget::ReleaseThreads(jobs);
+  }
+}
+
+bool CpuCompressionLibrary::SetArguments(const std::string &arguments) {
+  return arguments.empty();
+}
+
+bool CpuCompressionLibrary::IsStateless() { return true; }
+
+void CpuCompressionLibrary::Reset() {
+  initialized_compressor_ = false;
+  initialized_decompressor_ = false;
+  options_ = CpuOptions();
+}
+
 CpuOptions CpuCompressionLibrary::GetOptions() { return options_; }
 
 CpuCompressionLibrary::CpuCompressionLibrary() {
@@ -0,0 +1,19 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+// Entry point of a compression library built as a plugin. The header and the
+// class of the library are given by CPU_SMASH_PLUGIN_HEADER and
+// CPU_SMASH_PLUGIN_LIBRARY.
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_library.hpp>
+#include CPU_SMASH_PLUGIN_HEADER
+
+extern "C" CpuCompressionLibrary *CpuSmashCreateLibrary() {
+  return new CPU_SMASH_PLUGIN_LIBRARY();
+}
@@ -0,0 +1,231 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#include <algorithm>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_dedup.hpp>
+#include <cpu_hash.hpp>
+
+// Format: size of the data, size of the chunks and size of the compressed new
+// chunks (8 bytes each), the token of every chunk (4 bytes each) and the
+// compressed new chunks. The token is the position of the chunk in the cache,
+// or kNewChunk
+
+static const uint32_t kNewChunk = UINT32_MAX;
+
+uint64_t CpuDedup::GetHeaderSize(const uint64_t &data_size) {
+  const uint64_t chunks = (data_size + chunk_size_ - 1) / chunk_size_;
+  return 3 * sizeof(uint64_t) + chunks * sizeof(uint32_t);
+}
+
+uint32_t CpuDedup::AddChunk(const char *const chunk) {
+  // The oldest chunk is replaced when the cache is full
+  if (cache_.empty()) cache_.resize(cache_chunks_ * chunk_size_);
+  if (used_chunks_ == cache_chunks_) {
+    auto position = positions_.find(hashes_[next_chunk_]);
+    if (position != positions_.end() && position->second == next_chunk_) {
+      positions_.erase(position);
+    }
+  } else {
+    ++used_chunks_;
+  }
+  const uint32_t result = next_chunk_;
+  memcpy(cache_.data() + result * chunk_size_, chunk, chunk_size_);
+  next_chunk_ = (next_chunk_ + 1) % cache_chunks_;
+  return result;
+}
+
+bool CpuDedup::SetOptionsCompressor(CpuOptions *options) {
+  return smash_.SetOptionsCompressor(options);
+}
+
+bool CpuDedup::SetOptionsDecompressor(CpuOptions *options) {
+  return smash_.SetOptionsDecompressor(options);
+}
+
+void CpuDedup::GetCompressedDataSize(const char *const uncompressed_data,
+                                     const uint64_t &uncompressed_data_size,
+                                     uint64_t *compressed_data_size) {
+  // The library compresses the new chunks, not this data
+  smash_.GetCompressedDataSize(nullptr, uncompressed_data_size,
+                               compressed_data_size);
+  *compressed_data_size += GetHeaderSize(uncompressed_data_size);
+}
+
+bool CpuDedup::Compress(const char *const uncompressed_data,
+                        const uint64_t &uncompressed_data_size,
+                        char *compressed_data, uint64_t *compressed_data_size) {
+  const uint64_t header_size = GetHeaderSize(uncompressed_data_size);
+  bool result{header_size <= *compressed_data_size};
+  if (result) {
+    const uint64_t chunks =
+        (header_size - 3 * sizeof(uint64_t)) / sizeof(uint32_t);
+    tokens_.resize(chunks);
+    if (new_data_.size() < uncompressed_data_size) {
+      new_data_.resize(uncompressed_data_size);
+    }
+    uint64_t new_size{0};
+    for (uint64_t i = 0; i < chunks; ++i) {
+      const char *chunk = uncompressed_data + i * chunk_size_;
+      const uint64_t size =
+          std::min(chunk_size_, uncompressed_data_size - i * chunk_size_);
+      tokens_[i] = kNewChunk;
+      // Only full chunks are in the cache
+      if (size == chunk_size_) {
+        const uint64_t hash = CpuHash::Hash(chunk, size);
+        auto position = positions_.find(hash);
+        if (position != positions_.end() &&
+            memcmp(cache_.data() + position->second * chunk_size_, chunk,
+                   size) == 0) {
+          tokens_[i] = position->second;
+          ++duplicated_chunks_;
+        } else {
+          const uint32_t new_position = AddChunk(chunk);
+          positions_[hash] = new_position;
+          hashes_[new_position] = hash;
+        }
+      }
+      if (tokens_[i] == kNewChunk) {
+        memcpy(new_data_.data() + new_size, chunk, size);
+        new_size += size;
+      }
+    }
+    total_chunks_ += chunks;
+    uint64_t new_compressed_size{0};
+    if (new_size) {
+      // Without duplicated chunks, the data is compressed without a copy
+      new_compressed_size = *compressed_data_size - header_size;
+      result = smash_.Compress(new_size == uncompressed_data_size
+                                   ? uncompressed_data
+                                   : new_data_.data(),
+                               new_size, compressed_data + header_size,
+                               &new_compressed_size);
+    }
+    if (result) {
+      const uint64_t header[3] = {uncompressed_data_size, chunk_size_,
+                                  new_compressed_size};
+      memcpy(compressed_data, header, sizeof(header));
+      memcpy(compressed_data + sizeof(header), tokens_.data(),
+             chunks * sizeof(uint32_t));
+      *compressed_data_size = header_size + new_compressed_size;
+    }
+  }
+  if (!result) {
+    std::cout << "ERROR: dedup error when compress data" << std::endl;
+  }
+  return result;
+}
+
+void CpuDedup::GetDecompressedDataSize(const char *const compressed_data,
+                                       const uint64_t &compressed_data_size,
+                                       uint64_t *decompressed_data_size) {
+  *decompressed_data_size = 0;
+  if (compressed_data_size >= sizeof(uint64_t)) {
+    memcpy(decompressed_data_size, compressed_data, sizeof(uint64_t));
+  }
+}
+
+bool CpuDedup::Decompress(const char *const compressed_data,
+                          const uint64_t &compressed_data_size,
+                          char *decompressed_data,
+                          uint64_t *decompressed_data_size) {
+  uint64_t header[3] = {0, 0, 0};
+  bool result{compressed_data_size >= sizeof(header)};
+  if (result) {
+    memcpy(header, compressed_data, sizeof(header));
+    result = header[0] <= *decompressed_data_size && header[1] == chunk_size_;
+  }
+  const uint64_t header_size = result ? GetHeaderSize(header[0]) : 0;
+  if (result) {
+    result = header_size <= compressed_data_size &&
+             header[2] == compressed_data_size - header_size;
+  }
+  if (result) {
+    const uint64_t chunks = (header_size - sizeof(header)) / sizeof(uint32_t);
+    tokens_.resize(chunks);
+    memcpy(tokens_.data(), compressed_data + sizeof(header),
+           chunks * sizeof(uint32_t));
+    uint64_t new_size{0};
+    for (uint64_t i = 0; i < chunks; ++i) {
+      if (tokens_[i] == kNewChunk) {
+        new_size += std::min(chunk_size_, header[0] - i * chunk_size_);
+      }
+    }
+    // Without duplicated chunks, the data is decompressed in its place
+    char *new_data = decompressed_data;
+    if (new_size != header[0]) {
+      if (new_data_.size() < new_size) new_data_.resize(new_size);
+      new_data = new_data_.data();
+    }
+    if (new_size) {
+      uint64_t size = new_size;
+      result = header[2] > 0 &&
+               smash_.Decompress(compressed_data + header_size, header[2],
+                                 new_data, &size) &&
+               size == new_size;
+    } else {
+      result = header[2] == 0;
+    }
+    new_size = 0;
+    for (uint64_t i = 0; result && i < chunks; ++i) {
+      char *chunk = decompressed_data + i * chunk_size_;
+      const uint64_t size = std::min(chunk_size_, header[0] - i * chunk_size_);
+      if (tokens_[i] == kNewChunk) {
+        if (new_data != decompressed_data) {
+          memcpy(chunk, new_data + new_size, size);
+        }
+        new_size += size;
+        if (size == chunk_size_) AddChunk(chunk);
+      } else {
+        result = tokens_[i] < used_chunks_ && size == chunk_size_;
+        if (result) {
+          memcpy(chunk, cache_.data() + tokens_[i] * chunk_size_, size);
+          ++duplicated_chunks_;
+        }
+      }
+    }
+    total_chunks_ += chunks;
+  }
+  if (result) {
+    *decompressed_data_size = header[0];
+  } else {
+    std::cout << "ERROR: dedup error when decompress data" << std::endl;
+  }
+  return result;
+}
+
+void CpuDedup::Clear() {
+  positions_.clear();
+  used_chunks_ = 0;
+  next_chunk_ = 0;
+}
+
+uint64_t CpuDedup::GetDuplicatedChunks() const { return duplicated_chunks_; }
+
+uint64_t CpuDedup::GetTotalChunks() const { return total_chunks_; }
+
+CpuDedup::CpuDedup(const std::string &compression_library_name,
+                   const uint64_t &chunk_size, const uint32_t &cache_chunks)
+    : smash_(compression_library_name),
+      chunk_size_(chunk_size),
+      cache_chunks_(cache_chunks),
+      used_chunks_(0),
+      next_chunk_(0),
+      hashes_(cache_chunks),
+      duplicated_chunks_(0),
+      total_chunks_(0) {
+  if (chunk_size_ == 0 || cache_chunks_ == 0 || cache_chunks_ == kNewChunk) {
+    std::cout << "ERROR: The chunk size or the number of chunks of the dedup "
+                 "cache is not valid"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
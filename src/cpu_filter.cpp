@@ -0,0 +1,787 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// CPU-SMASH LIBRARIES
+#include <cpu_filter.hpp>
+
+namespace {
+
+// The byte shuffle stores the byte j of all elements together (planes). The
+// SIMD versions process blocks of 16 elements and return the number of
+// elements processed, the rest are processed by the generic version
+#if defined(__SSE2__)
+uint64_t ByteShuffleSimd(const uint8_t *source, const uint64_t &elements,
+                         const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t blocks = elements / 16 * 16;
+  __m128i x[8], t[8];
+  if (element_size == 2) {
+    const __m128i mask = _mm_set1_epi16(0xFF);
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      x[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 2 * i));
+      x[1] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(source + 2 * i + 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                       _mm_packus_epi16(_mm_and_si128(x[0], mask),
+                                        _mm_and_si128(x[1], mask)));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(destination + elements + i),
+          _mm_packus_epi16(_mm_srli_epi16(x[0], 8), _mm_srli_epi16(x[1], 8)));
+    }
+  } else if (element_size == 4) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      for (uint8_t k = 0; k < 4; ++k) {
+        x[k] = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(source + 4 * i + 16 * k));
+      }
+      for (uint8_t j = 0; j < 4; ++j) {
+        const __m128i shift = _mm_cvtsi32_si128(8 * j);
+        for (uint8_t k = 0; k < 4; ++k) {
+          t[k] = _mm_and_si128(_mm_srl_epi32(x[k], shift), mask);
+        }
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(destination + j * elements + i),
+            _mm_packus_epi16(_mm_packs_epi32(t[0], t[1]),
+                             _mm_packs_epi32(t[2], t[3])));
+      }
+    }
+  } else if (element_size == 8) {
+    const __m128i mask = _mm_set1_epi64x(0xFF);
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      for (uint8_t k = 0; k < 8; ++k) {
+        x[k] = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(source + 8 * i + 16 * k));
+      }
+      for (uint8_t j = 0; j < 8; ++j) {
+        const __m128i shift = _mm_cvtsi32_si128(8 * j);
+        for (uint8_t k = 0; k < 8; ++k) {
+          // The low 32 bits of both 64-bit lanes are moved to the low half
+          t[k] = _mm_shuffle_epi32(
+              _mm_and_si128(_mm_srl_epi64(x[k], shift), mask),
+              _MM_SHUFFLE(3, 1, 2, 0));
+        }
+        for (uint8_t k = 0; k < 4; ++k) {
+          t[k] = _mm_unpacklo_epi64(t[2 * k], t[2 * k + 1]);
+        }
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(destination + j * elements + i),
+            _mm_packus_epi16(_mm_packs_epi32(t[0], t[1]),
+                             _mm_packs_epi32(t[2], t[3])));
+      }
+    }
+  } else {
+    return 0;
+  }
+  return blocks;
+}
+
+uint64_t ByteUnshuffleSimd(const uint8_t *source, const uint64_t &elements,
+                           const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t blocks = elements / 16 * 16;
+  __m128i p[8], a[8], b[8];
+  if (element_size == 2) {
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      p[0] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+      p[1] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(source + elements + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 2 * i),
+                       _mm_unpacklo_epi8(p[0], p[1]));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + 2 * i + 16),
+                       _mm_unpackhi_epi8(p[0], p[1]));
+    }
+  } else if (element_size == 4 || element_size == 8) {
+    const uint8_t pairs = element_size / 2;
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      for (uint8_t j = 0; j < element_size; ++j) {
+        p[j] = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(source + j * elements + i));
+      }
+      // Bytes 2k and 2k + 1 of elements 0-7 (a[k]) and 8-15 (a[k + pairs])
+      for (uint8_t k = 0; k < pairs; ++k) {
+        a[k] = _mm_unpacklo_epi8(p[2 * k], p[2 * k + 1]);
+        a[k + pairs] = _mm_unpackhi_epi8(p[2 * k], p[2 * k + 1]);
+      }
+      // Bytes 0-3 (b[0-3]) and 4-7 (b[4-7]) of four elements each
+      for (uint8_t k = 0; k < pairs / 2; ++k) {
+        for (uint8_t h = 0; h < 2; ++h) {
+          const __m128i &low = a[2 * k + h * pairs];
+          const __m128i &high = a[2 * k + 1 + h * pairs];
+          b[4 * k + 2 * h] = _mm_unpacklo_epi16(low, high);
+          b[4 * k + 2 * h + 1] = _mm_unpackhi_epi16(low, high);
+        }
+      }
+      uint8_t *output = destination + element_size * i;
+      if (element_size == 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output), b[0]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16), b[1]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 32), b[2]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 48), b[3]);
+      } else {
+        for (uint8_t k = 0; k < 4; ++k) {
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 32 * k),
+                           _mm_unpacklo_epi32(b[k], b[k + 4]));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 32 * k + 16),
+                           _mm_unpackhi_epi32(b[k], b[k + 4]));
+        }
+      }
+    }
+  } else {
+    return 0;
+  }
+  return blocks;
+}
+#elif defined(__ARM_NEON)
+uint64_t ByteShuffleSimd(const uint8_t *source, const uint64_t &elements,
+                         const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t blocks = elements / 16 * 16;
+  if (element_size == 2) {
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      uint8x16x2_t x = vld2q_u8(source + 2 * i);
+      vst1q_u8(destination + i, x.val[0]);
+      vst1q_u8(destination + elements + i, x.val[1]);
+    }
+  } else if (element_size == 4) {
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      uint8x16x4_t x = vld4q_u8(source + 4 * i);
+      for (uint8_t j = 0; j < 4; ++j) {
+        vst1q_u8(destination + j * elements + i, x.val[j]);
+      }
+    }
+  } else {
+    return 0;
+  }
+  return blocks;
+}
+
+uint64_t ByteUnshuffleSimd(const uint8_t *source, const uint64_t &elements,
+                           const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t blocks = elements / 16 * 16;
+  if (element_size == 2) {
+    uint8x16x2_t x;
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      x.val[0] = vld1q_u8(source + i);
+      x.val[1] = vld1q_u8(source + elements + i);
+      vst2q_u8(destination + 2 * i, x);
+    }
+  } else if (element_size == 4) {
+    uint8x16x4_t x;
+    for (uint64_t i = 0; i < blocks; i += 16) {
+      for (uint8_t j = 0; j < 4; ++j) {
+        x.val[j] = vld1q_u8(source + j * elements + i);
+      }
+      vst4q_u8(destination + 4 * i, x);
+    }
+  } else {
+    return 0;
+  }
+  return blocks;
+}
+#else
+uint64_t ByteShuffleSimd(const uint8_t *source, const uint64_t &elements,
+                         const uint8_t &element_size, uint8_t *destination) {
+  return 0;
+}
+
+uint64_t ByteUnshuffleSimd(const uint8_t *source, const uint64_t &elements,
+                           const uint8_t &element_size, uint8_t *destination) {
+  return 0;
+}
+#endif
+
+void ByteShuffle(const uint8_t *source, const uint64_t &elements,
+                 const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t first =
+      ByteShuffleSimd(source, elements, element_size, destination);
+  for (uint8_t j = 0; j < element_size; ++j) {
+    for (uint64_t i = first; i < elements; ++i) {
+      destination[j * elements + i] = source[i * element_size + j];
+    }
+  }
+}
+
+void ByteUnshuffle(const uint8_t *source, const uint64_t &elements,
+                   const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t first =
+      ByteUnshuffleSimd(source, elements, element_size, destination);
+  for (uint64_t i = first; i < elements; ++i) {
+    for (uint8_t j = 0; j < element_size; ++j) {
+      destination[i * element_size + j] = source[j * elements + i];
+    }
+  }
+}
+
+// Transposes the 8x8 bit matrix of 8 bytes: the bit i of the byte j is moved
+// to the bit j of the byte i
+inline uint64_t TransposeBits(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  return x ^ t ^ (t << 28);
+}
+
+// Splits a plane of bytes (multiple of 8) in 8 planes of bits, the bit i of
+// the byte p of the plane b is the bit b of the byte 8 * p + i
+void BitTranspose(const uint8_t *source, const uint64_t &size,
+                  uint8_t *destination) {
+  const uint64_t plane_size = size / 8;
+  uint64_t i{0};
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+    for (int8_t b = 7; b >= 0; --b) {
+      const uint16_t bits = static_cast<uint16_t>(_mm_movemask_epi8(x));
+      memcpy(destination + b * plane_size + i / 8, &bits, sizeof(bits));
+      x = _mm_slli_epi16(x, 1);
+    }
+  }
+#endif
+  uint64_t x;
+  for (; i < size; i += 8) {
+    memcpy(&x, source + i, sizeof(x));
+    x = TransposeBits(x);
+    for (uint8_t b = 0; b < 8; ++b) {
+      destination[b * plane_size + i / 8] = static_cast<uint8_t>(x >> (8 * b));
+    }
+  }
+}
+
+void BitUntranspose(const uint8_t *source, const uint64_t &size,
+                    uint8_t *destination) {
+  const uint64_t plane_size = size / 8;
+  uint64_t x;
+  for (uint64_t i = 0; i < size; i += 8) {
+    x = 0;
+    for (uint8_t b = 0; b < 8; ++b) {
+      x |= static_cast<uint64_t>(source[b * plane_size + i / 8]) << (8 * b);
+    }
+    x = TransposeBits(x);
+    memcpy(destination + i, &x, sizeof(x));
+  }
+}
+
+// Each element is replaced by its XOR with the previous one (the predictor).
+// Consecutive floating point values share sign and exponent bits, which
+// become zero. It works on bytes, so any element size is valid
+void XorDelta(const uint8_t *source, const uint64_t &size,
+              const uint8_t &element_size, uint8_t *destination) {
+  const uint64_t first = size < element_size ? size : element_size;
+  memcpy(destination, source, first);
+  uint64_t i{first};
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(destination + i),
+        _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                source + i - element_size))));
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= size; i += 16) {
+    vst1q_u8(destination + i, veorq_u8(vld1q_u8(source + i),
+                                       vld1q_u8(source + i - element_size)));
+  }
+#endif
+  for (; i < size; ++i) {
+    destination[i] = source[i] ^ source[i - element_size];
+  }
+}
+
+// Prefix XOR of the elements. With SSE2, 16 bytes are accumulated in
+// log2(16 / element size) steps, and the last element of the previous block
+// is added to all of them
+void XorUndelta(uint8_t *data, const uint64_t &size,
+                const uint8_t &element_size) {
+  uint64_t i{0};
+#if defined(__SSE2__)
+  if (element_size == 2 || element_size == 4 || element_size == 8) {
+    __m128i last = _mm_setzero_si128(), x;
+    for (; i + 16 <= size; i += 16) {
+      x = _mm_loadu_si128(reinterpret_cast<__m128i *>(data + i));
+      if (element_size == 2) {
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 2));
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+      } else if (element_size == 4) {
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+      }
+      x = _mm_xor_si128(x, _mm_slli_si128(x, 8));
+      x = _mm_xor_si128(x, last);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), x);
+      if (element_size == 2) {
+        last = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+        last = _mm_unpackhi_epi64(last, last);
+      } else if (element_size == 4) {
+        last = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+      } else {
+        last = _mm_unpackhi_epi64(x, x);
+      }
+    }
+  }
+#endif
+  if (i == 0) i = element_size;
+  for (; i < size; ++i) {
+    data[i] ^= data[i - element_size];
+  }
+}
+
+// Integers stored as the difference with the previous one (order 1) or as
+// the difference of two consecutive differences (order 2), in zigzag format
+// so that small negative values are small too. The previous values of the
+// first elements are 0
+template <class T>
+inline T Load(const uint8_t *data) {
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <class T>
+inline void Store(uint8_t *data, const T &value) {
+  memcpy(data, &value, sizeof(T));
+}
+
+template <class T>
+inline T ZigZag(const T &value) {
+  return static_cast<T>(value << 1) ^
+         static_cast<T>(0 - (value >> (8 * sizeof(T) - 1)));
+}
+
+template <class T>
+inline T UnZigZag(const T &value) {
+  return static_cast<T>(value >> 1) ^ static_cast<T>(0 - (value & 1));
+}
+
+template <class T>
+inline T Predict(const uint8_t *data, const uint64_t &i, const uint8_t &order) {
+  T current = Load<T>(data + i * sizeof(T));
+  T previous = i > 0 ? Load<T>(data + (i - 1) * sizeof(T)) : 0;
+  T result = current - previous;
+  if (order == 2) {
+    T before_previous = i > 1 ? Load<T>(data + (i - 2) * sizeof(T)) : 0;
+    result = result - static_cast<T>(previous - before_previous);
+  }
+  return result;
+}
+
+#if defined(__SSE2__)
+template <class T>
+__m128i AddLanes(const __m128i &a, const __m128i &b);
+template <>
+__m128i AddLanes<uint8_t>(const __m128i &a, const __m128i &b) {
+  return _mm_add_epi8(a, b);
+}
+template <>
+__m128i AddLanes<uint16_t>(const __m128i &a, const __m128i &b) {
+  return _mm_add_epi16(a, b);
+}
+template <>
+__m128i AddLanes<uint32_t>(const __m128i &a, const __m128i &b) {
+  return _mm_add_epi32(a, b);
+}
+template <>
+__m128i AddLanes<uint64_t>(const __m128i &a, const __m128i &b) {
+  return _mm_add_epi64(a, b);
+}
+
+template <class T>
+__m128i SubLanes(const __m128i &a, const __m128i &b);
+template <>
+__m128i SubLanes<uint8_t>(const __m128i &a, const __m128i &b) {
+  return _mm_sub_epi8(a, b);
+}
+template <>
+__m128i SubLanes<uint16_t>(const __m128i &a, const __m128i &b) {
+  return _mm_sub_epi16(a, b);
+}
+template <>
+__m128i SubLanes<uint32_t>(const __m128i &a, const __m128i &b) {
+  return _mm_sub_epi32(a, b);
+}
+template <>
+__m128i SubLanes<uint64_t>(const __m128i &a, const __m128i &b) {
+  return _mm_sub_epi64(a, b);
+}
+
+template <class T>
+__m128i ZigZagLanes(const __m128i &x);
+template <>
+__m128i ZigZagLanes<uint8_t>(const __m128i &x) {
+  return _mm_xor_si128(_mm_add_epi8(x, x),
+                       _mm_cmpgt_epi8(_mm_setzero_si128(), x));
+}
+template <>
+__m128i ZigZagLanes<uint16_t>(const __m128i &x) {
+  return _mm_xor_si128(_mm_slli_epi16(x, 1), _mm_srai_epi16(x, 15));
+}
+template <>
+__m128i ZigZagLanes<uint32_t>(const __m128i &x) {
+  return _mm_xor_si128(_mm_slli_epi32(x, 1), _mm_srai_epi32(x, 31));
+}
+template <>
+__m128i ZigZagLanes<uint64_t>(const __m128i &x) {
+  // The sign of the high 32 bits is copied to the whole 64-bit lane
+  return _mm_xor_si128(
+      _mm_slli_epi64(x, 1),
+      _mm_shuffle_epi32(_mm_srai_epi32(x, 31), _MM_SHUFFLE(3, 3, 1, 1)));
+}
+
+template <class T>
+__m128i UnZigZagLanes(const __m128i &x);
+template <>
+__m128i UnZigZagLanes<uint8_t>(const __m128i &x) {
+  const __m128i one = _mm_set1_epi8(1);
+  return _mm_xor_si128(
+      _mm_and_si128(_mm_srli_epi16(x, 1), _mm_set1_epi8(0x7F)),
+      _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(x, one)));
+}
+template <>
+__m128i UnZigZagLanes<uint16_t>(const __m128i &x) {
+  const __m128i one = _mm_set1_epi16(1);
+  return _mm_xor_si128(
+      _mm_srli_epi16(x, 1),
+      _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(x, one)));
+}
+template <>
+__m128i UnZigZagLanes<uint32_t>(const __m128i &x) {
+  const __m128i one = _mm_set1_epi32(1);
+  return _mm_xor_si128(
+      _mm_srli_epi32(x, 1),
+      _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+}
+template <>
+__m128i UnZigZagLanes<uint64_t>(const __m128i &x) {
+  const __m128i one = _mm_set1_epi64x(1);
+  return _mm_xor_si128(
+      _mm_srli_epi64(x, 1),
+      _mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(x, one)));
+}
+
+// Copies the last lane to all lanes
+template <class T>
+__m128i BroadcastLastLane(const __m128i &x);
+template <>
+__m128i BroadcastLastLane<uint8_t>(const __m128i &x) {
+  __m128i y = _mm_shufflehi_epi16(_mm_unpackhi_epi8(x, x),
+                                  _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_unpackhi_epi64(y, y);
+}
+template <>
+__m128i BroadcastLastLane<uint16_t>(const __m128i &x) {
+  __m128i y = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_unpackhi_epi64(y, y);
+}
+template <>
+__m128i BroadcastLastLane<uint32_t>(const __m128i &x) {
+  return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+template <>
+__m128i BroadcastLastLane<uint64_t>(const __m128i &x) {
+  return _mm_unpackhi_epi64(x, x);
+}
+
+// Adds to each lane the previous ones, in log2(lanes) steps
+template <class T>
+__m128i PrefixSumLanes(__m128i x) {
+  if (sizeof(T) <= 1) x = AddLanes<T>(x, _mm_slli_si128(x, 1));
+  if (sizeof(T) <= 2) x = AddLanes<T>(x, _mm_slli_si128(x, 2));
+  if (sizeof(T) <= 4) x = AddLanes<T>(x, _mm_slli_si128(x, 4));
+  return AddLanes<T>(x, _mm_slli_si128(x, 8));
+}
+#endif
+
+template <class T>
+void DeltaEncode(const uint8_t *source, const uint64_t &elements,
+                 const uint8_t &order, uint8_t *destination) {
+  uint64_t i{0};
+  for (; i < elements && i < order; ++i) {
+    Store<T>(destination + i * sizeof(T),
+             ZigZag<T>(Predict<T>(source, i, order)));
+  }
+#if defined(__SSE2__)
+  const uint64_t lanes = 16 / sizeof(T);
+  __m128i x;
+  for (; i + lanes <= elements; i += lanes) {
+    const uint8_t *current = source + i * sizeof(T);
+    x = SubLanes<T>(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(current)),
+        _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(current - sizeof(T))));
+    if (order == 2) {
+      x = SubLanes<T>(
+          x, SubLanes<T>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                             current - sizeof(T))),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                             current - 2 * sizeof(T)))));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * sizeof(T)),
+                     ZigZagLanes<T>(x));
+  }
+#endif
+  for (; i < elements; ++i) {
+    Store<T>(destination + i * sizeof(T),
+             ZigZag<T>(Predict<T>(source, i, order)));
+  }
+}
+
+// Accumulates the elements in place, decoding the zigzag format first if
+// requested
+template <class T>
+void PrefixSum(uint8_t *data, const uint64_t &elements, const bool &zigzag) {
+  uint64_t i{0};
+  T last{0};
+#if defined(__SSE2__)
+  const uint64_t lanes = 16 / sizeof(T);
+  __m128i x, carry = _mm_setzero_si128();
+  for (; i + lanes <= elements; i += lanes) {
+    x = _mm_loadu_si128(reinterpret_cast<__m128i *>(data + i * sizeof(T)));
+    if (zigzag) x = UnZigZagLanes<T>(x);
+    x = AddLanes<T>(PrefixSumLanes<T>(x), carry);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i * sizeof(T)), x);
+    carry = BroadcastLastLane<T>(x);
+  }
+  if (i > 0) last = Load<T>(data + (i - 1) * sizeof(T));
+#endif
+  T value;
+  for (; i < elements; ++i) {
+    value = Load<T>(data + i * sizeof(T));
+    if (zigzag) value = UnZigZag<T>(value);
+    last = last + value;
+    Store<T>(data + i * sizeof(T), last);
+  }
+}
+
+template <class T>
+void DeltaDecode(uint8_t *data, const uint64_t &elements,
+                 const uint8_t &order) {
+  PrefixSum<T>(data, elements, true);
+  if (order == 2) PrefixSum<T>(data, elements, false);
+}
+
+void DeltaEncode(const uint8_t *source, const uint64_t &elements,
+                 const uint8_t &element_size, const uint8_t &order,
+                 uint8_t *destination) {
+  switch (element_size) {
+    case 1:
+      DeltaEncode<uint8_t>(source, elements, order, destination);
+      break;
+    case 2:
+      DeltaEncode<uint16_t>(source, elements, order, destination);
+      break;
+    case 4:
+      DeltaEncode<uint32_t>(source, elements, order, destination);
+      break;
+    case 8:
+      DeltaEncode<uint64_t>(source, elements, order, destination);
+      break;
+  }
+}
+
+void DeltaDecode(uint8_t *data, const uint64_t &elements,
+                 const uint8_t &element_size, const uint8_t &order) {
+  switch (element_size) {
+    case 1:
+      DeltaDecode<uint8_t>(data, elements, order);
+      break;
+    case 2:
+      DeltaDecode<uint16_t>(data, elements, order);
+      break;
+    case 4:
+      DeltaDecode<uint32_t>(data, elements, order);
+      break;
+    case 8:
+      DeltaDecode<uint64_t>(data, elements, order);
+      break;
+  }
+}
+
+}  // namespace
+
+bool CpuFilter::SetOptions(CpuOptions *options) {
+  bool result{true};
+  if (options->DataTypeIsSet() && options->GetDataType() > kCpuText) {
+    std::cout << "ERROR: Data type can not be higher than "
+              << static_cast<uint64_t>(kCpuText) << std::endl;
+    result = false;
+  } else if (!options->FilterIsSet()) {
+    // The filter is not recorded in the compressed data, so it is never
+    // taken from the data type
+    options->SetFilter(0);
+  } else if (options->GetFilter() >= number_of_filters_) {
+    std::cout << "ERROR: Filter can not be higher than "
+              << static_cast<uint64_t>(number_of_filters_ - 1) << std::endl;
+    result = false;
+  }
+  if (!options->ElementSizeIsSet()) {
+    // The size is only set when it is used, so the libraries that take it as
+    // a hint (e.g., c-blosc2) keep their default otherwise
+    if (options->DataTypeIsSet()) {
+      options->SetElementSize(options->GetDataTypeSize());
+    } else if (options->GetFilter() != 0) {
+      options->SetElementSize(4);
+    }
+  } else if (options->GetElementSize() < 1) {
+    std::cout << "ERROR: Element size can not be lower than 1" << std::endl;
+    result = false;
+  }
+  if (result && (options->GetFilter() == 4 || options->GetFilter() == 5)) {
+    const uint8_t element_size = options->GetElementSize();
+    if (element_size != 1 && element_size != 2 && element_size != 4 &&
+        element_size != 8) {
+      std::cout << "ERROR: Element size must be 1, 2, 4 or 8 using "
+                << filters_[options->GetFilter()] << std::endl;
+      result = false;
+    }
+  }
+  if (result) {
+    filter_ = options->GetFilter();
+    element_size_ = options->ElementSizeIsSet() ? options->GetElementSize() : 4;
+  } else {
+    filter_ = 0;
+  }
+  return result;
+}
+
+bool CpuFilter::IsSet() const { return filter_ != 0; }
+
+const char *CpuFilter::Apply(const char *const data,
+                             const uint64_t &data_size) {
+  if (filter_ == 0 || data_size == 0) return data;
+  if (buffer_.size() < data_size) buffer_.resize(data_size);
+  const uint8_t *source = reinterpret_cast<const uint8_t *>(data);
+  uint8_t *destination = reinterpret_cast<uint8_t *>(buffer_.data());
+  uint64_t elements = data_size / element_size_;
+  if (filter_ == 1) {
+    ByteShuffle(source, elements, element_size_, destination);
+  } else if (filter_ == 2) {
+    // Only blocks of 8 elements are split in bits
+    elements &= ~7ULL;
+    if (scratch_.size() < elements * element_size_) {
+      scratch_.resize(elements * element_size_);
+    }
+    uint8_t *planes = reinterpret_cast<uint8_t *>(scratch_.data());
+    ByteShuffle(source, elements, element_size_, planes);
+    for (uint8_t j = 0; j < element_size_; ++j) {
+      BitTranspose(planes + j * elements, elements,
+                   destination + j * elements);
+    }
+  } else if (filter_ == 3) {
+    XorDelta(source, elements * element_size_, element_size_, destination);
+  } else if (filter_ == 4 || filter_ == 5) {
+    DeltaEncode(source, elements, element_size_, filter_ - 3, destination);
+  }
+  // The bytes of the last incomplete elements are not modified
+  memcpy(destination + elements * element_size_,
+         source + elements * element_size_,
+         data_size - elements * element_size_);
+  return buffer_.data();
+}
+
+void CpuFilter::Revert(char *data, const uint64_t &data_size) {
+  if (filter_ == 0 || data_size == 0) return;
+  uint8_t *destination = reinterpret_cast<uint8_t *>(data);
+  uint64_t elements = data_size / element_size_;
+  if (elements == 0) return;
+  if (filter_ == 1) {
+    if (buffer_.size() < elements * element_size_) {
+      buffer_.resize(elements * element_size_);
+    }
+    memcpy(buffer_.data(), data, elements * element_size_);
+    ByteUnshuffle(reinterpret_cast<uint8_t *>(buffer_.data()), elements,
+                  element_size_, destination);
+  } else if (filter_ == 2) {
+    elements &= ~7ULL;
+    if (scratch_.size() < elements * element_size_) {
+      scratch_.resize(elements * element_size_);
+    }
+    uint8_t *planes = reinterpret_cast<uint8_t *>(scratch_.data());
+    for (uint8_t j = 0; j < element_size_; ++j) {
+      BitUntranspose(destination + j * elements, elements,
+                     planes + j * elements);
+    }
+    ByteUnshuffle(planes, elements, element_size_, destination);
+  } else if (filter_ == 3) {
+    XorUndelta(destination, elements * element_size_, element_size_);
+  } else if (filter_ == 4 || filter_ == 5) {
+    DeltaDecode(destination, elements, element_size_, filter_ - 3);
+  }
+}
+
+bool CpuFilter::GetFilterInformation(
+    std::vector<std::string> *filter_information, uint8_t *minimum_filter,
+    uint8_t *maximum_filter) {
+  if (minimum_filter) *minimum_filter = 0;
+  if (maximum_filter) *maximum_filter = number_of_filters_ - 1;
+  if (filter_information) {
+    filter_information->clear();
+    filter_information->push_back("Available values [0-5]");
+    filter_information->push_back("0: " + filters_[0]);
+    filter_information->push_back("1: " + filters_[1] +
+                                  " (bytes grouped by significance)");
+    filter_information->push_back("2: " + filters_[2] +
+                                  " (bits grouped by significance)");
+    filter_information->push_back(
+        "3: " + filters_[3] +
+        " (XOR with the previous element, for floating point data)");
+    filter_information->push_back(
+        "4: " + filters_[4] +
+        " (difference with the previous integer, element size 1, 2, 4 or 8)");
+    filter_information->push_back(
+        "5: " + filters_[5] +
+        " (difference of differences, element size 1, 2, 4 or 8)");
+    filter_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
+bool CpuFilter::GetElementSizeInformation(
+    std::vector<std::string> *element_size_information, uint8_t *minimum_size,
+    uint8_t *maximum_size) {
+  if (minimum_size) *minimum_size = 1;
+  if (maximum_size) *maximum_size = 255;
+  if (element_size_information) {
+    element_size_information->clear();
+    element_size_information->push_back("Available values [1-255]");
+    element_size_information->push_back("Bytes of each element (4 by default)");
+    element_size_information->push_back("[compression/decompression]");
+  }
+  return true;
+}
+
+std::string CpuFilter::GetFilterName(const uint8_t &filter) {
+  std::string result = "ERROR";
+  if (filter < number_of_filters_) {
+    result = filters_[filter];
+  }
+  return result;
+}
+
+CpuFilter::CpuFilter() {
+  filter_ = 0;
+  element_size_ = 4;
+  number_of_filters_ = 6;
+  filters_ = new std::string[number_of_filters_];
+  filters_[0] = "None";
+  filters_[1] = "Byte shuffle";
+  filters_[2] = "Bit shuffle";
+  filters_[3] = "XOR delta";
+  filters_[4] = "Delta";
+  filters_[5] = "Delta of delta";
+}
+
+CpuFilter::~CpuFilter() { delete[] filters_; }
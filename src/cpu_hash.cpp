@@ -0,0 +1,174 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// CPU-SMASH LIBRARIES
+#include <cpu_hash.hpp>
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint32_t kPrime3 = 0x9E3779B1U;
+
+// Stripes of 32 bytes are accumulated in blocks of kBlockStripes, and the
+// accumulators are scrambled after every block
+const uint64_t kBlockStripes = 8;
+
+// As XXH3, the secret of every lane moves 8 bytes with every stripe of a
+// block, so the order of the stripes changes the hash. The last secrets are
+// also used to scramble the accumulators
+const uint64_t kSecrets[12] = {
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL,
+    0x1F67B3B7A4A44072ULL, 0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL,
+    0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL, 0xCB00C391BB52283CULL,
+    0xA32E531B8B65D088ULL, 0x4EF90DA297486471ULL, 0xD8ACDEA946EF1938ULL};
+const uint64_t *const kScrambleSecrets = kSecrets + kBlockStripes;
+
+// Final mix of MurmurHash3
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Adds a stripe of 32 bytes to 4 lanes, as XXH3: every 8 bytes are XORed
+// with the secret of their lane and stripe, their two halves are multiplied
+// and the 8 bytes of the neighbour lane are added
+void AccumulateStripe(const uint8_t *data, const uint64_t &stripe,
+                      uint64_t *lanes) {
+  uint64_t x[4];
+  memcpy(x, data, sizeof(x));
+  for (uint8_t k = 0; k < 4; ++k) {
+    const uint64_t key = x[k] ^ kSecrets[stripe + k];
+    lanes[k] += (key & 0xFFFFFFFF) * (key >> 32) + x[k ^ 1];
+  }
+}
+
+#if !defined(__SSE2__) && !defined(__ARM_NEON)
+// Scramble of XXH3 after every block, so the blocks are not simply added
+void Scramble(uint64_t *lanes) {
+  for (uint8_t k = 0; k < 4; ++k) {
+    lanes[k] = ((lanes[k] ^ (lanes[k] >> 47)) ^ kScrambleSecrets[k]) * kPrime3;
+  }
+}
+#endif
+
+// Accumulates full blocks. The SIMD versions keep the lanes in registers and
+// give the same result as the generic version
+void AccumulateBlocks(const uint8_t *data, const uint64_t &blocks,
+                      uint64_t *lanes) {
+#if defined(__SSE2__)
+  __m128i accumulators[2], scramble_secrets[2];
+  const __m128i prime = _mm_set1_epi32(kPrime3);
+  for (uint8_t j = 0; j < 2; ++j) {
+    accumulators[j] =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes + 2 * j));
+    scramble_secrets[j] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(kScrambleSecrets + 2 * j));
+  }
+  for (uint64_t block = 0; block < blocks; ++block) {
+    for (uint64_t i = 0; i < kBlockStripes; ++i, data += 32) {
+      for (uint8_t j = 0; j < 2; ++j) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * j));
+        const __m128i key = _mm_xor_si128(
+            x, _mm_loadu_si128(
+                   reinterpret_cast<const __m128i *>(kSecrets + i + 2 * j)));
+        const __m128i product = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));
+        accumulators[j] = _mm_add_epi64(
+            accumulators[j],
+            _mm_add_epi64(product,
+                          _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2))));
+      }
+    }
+    // The 64-bit product is made of the products of both halves
+    for (uint8_t j = 0; j < 2; ++j) {
+      __m128i x = _mm_xor_si128(accumulators[j],
+                                _mm_srli_epi64(accumulators[j], 47));
+      x = _mm_xor_si128(x, scramble_secrets[j]);
+      accumulators[j] = _mm_add_epi64(
+          _mm_mul_epu32(x, prime),
+          _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), prime), 32));
+    }
+  }
+  for (uint8_t j = 0; j < 2; ++j) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 2 * j),
+                     accumulators[j]);
+  }
+#elif defined(__ARM_NEON)
+  uint64x2_t accumulators[2], scramble_secrets[2];
+  for (uint8_t j = 0; j < 2; ++j) {
+    accumulators[j] = vld1q_u64(lanes + 2 * j);
+    scramble_secrets[j] = vld1q_u64(kScrambleSecrets + 2 * j);
+  }
+  for (uint64_t block = 0; block < blocks; ++block) {
+    for (uint64_t i = 0; i < kBlockStripes; ++i, data += 32) {
+      for (uint8_t j = 0; j < 2; ++j) {
+        const uint64x2_t x = vreinterpretq_u64_u8(vld1q_u8(data + 16 * j));
+        const uint64x2_t key = veorq_u64(x, vld1q_u64(kSecrets + i + 2 * j));
+        const uint64x2_t product =
+            vmull_u32(vmovn_u64(key), vshrn_n_u64(key, 32));
+        accumulators[j] = vaddq_u64(accumulators[j],
+                                    vaddq_u64(product, vextq_u64(x, x, 1)));
+      }
+    }
+    for (uint8_t j = 0; j < 2; ++j) {
+      uint64x2_t x =
+          veorq_u64(accumulators[j], vshrq_n_u64(accumulators[j], 47));
+      x = veorq_u64(x, scramble_secrets[j]);
+      accumulators[j] = vaddq_u64(
+          vmull_n_u32(vmovn_u64(x), kPrime3),
+          vshlq_n_u64(vmull_n_u32(vshrn_n_u64(x, 32), kPrime3), 32));
+    }
+  }
+  for (uint8_t j = 0; j < 2; ++j) vst1q_u64(lanes + 2 * j, accumulators[j]);
+#else
+  for (uint64_t block = 0; block < blocks; ++block) {
+    for (uint64_t i = 0; i < kBlockStripes; ++i, data += 32) {
+      AccumulateStripe(data, i, lanes);
+    }
+    Scramble(lanes);
+  }
+#endif
+}
+
+}  // namespace
+
+uint64_t CpuHash::Hash(const char *const data, const uint64_t &data_size) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+  uint64_t lanes[4] = {kPrime1, kPrime2, ~kPrime1, ~kPrime2};
+  const uint64_t stripes = data_size / 32;
+  const uint64_t blocks = stripes / kBlockStripes;
+  AccumulateBlocks(bytes, blocks, lanes);
+  // The remaining stripes start a new block. The last bytes are padded with
+  // zeros, the size tells them apart
+  const uint64_t position = 32 * kBlockStripes * blocks;
+  uint8_t last[32] = {0};
+  for (uint64_t stripe = 0; position + 32 * stripe < data_size; ++stripe) {
+    const uint8_t *data_stripe = bytes + position + 32 * stripe;
+    if (data_size - position - 32 * stripe < 32) {
+      memcpy(last, data_stripe, data_size - position - 32 * stripe);
+      data_stripe = last;
+    }
+    AccumulateStripe(data_stripe, stripe, lanes);
+  }
+  uint64_t result = data_size * kPrime1;
+  for (uint8_t k = 0; k < 4; ++k) result = (result ^ Mix(lanes[k])) * kPrime2;
+  return Mix(result);
+}
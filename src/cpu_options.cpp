@@ -44,6 +44,26 @@ void CpuOptions::SetBackReference(const uint8_t &back_reference) {
   back_reference_set_ = true;
 }
 
+void CpuOptions::SetFilter(const uint8_t &filter) {
+  filter_ = filter;
+  filter_set_ = true;
+}
+
+void CpuOptions::SetElementSize(const uint8_t &element_size) {
+  element_size_ = element_size;
+  element_size_set_ = true;
+}
+
+void CpuOptions::SetDataType(const uint8_t &data_type) {
+  data_type_ = data_type;
+  data_type_set_ = true;
+}
+
+void CpuOptions::SetShape(const std::vector<uint64_t> &shape) {
+  shape_ = shape;
+  shape_set_ = true;
+}
+
 bool CpuOptions::CompressionLevelIsSet() const {
   return compression_level_set_;
 }
@@ -60,6 +80,14 @@ bool CpuOptions::NumberThreadsIsSet() const { return number_threads_set_; }
 
 bool CpuOptions::BackReferenceIsSet() const { return back_reference_set_; }
 
+bool CpuOptions::FilterIsSet() const { return filter_set_; }
+
+bool CpuOptions::ElementSizeIsSet() const { return element_size_set_; }
+
+bool CpuOptions::DataTypeIsSet() const { return data_type_set_; }
+
+bool CpuOptions::ShapeIsSet() const { return shape_set_; }
+
 uint8_t CpuOptions::GetCompressionLevel() const { return compression_level_; }
 
 uint32_t CpuOptions::GetWindowSize() const { return window_size_; }
@@ -74,6 +102,46 @@ uint8_t CpuOptions::GetNumberThreads() const { return number_threads_; }
 
 uint8_t CpuOptions::GetBackReference() const { return back_reference_; }
 
+uint8_t CpuOptions::GetFilter() const { return filter_; }
+
+uint8_t CpuOptions::GetElementSize() const { return element_size_; }
+
+uint8_t CpuOptions::GetDataType() const { return data_type_; }
+
+std::vector<uint64_t> CpuOptions::GetShape() const { return shape_; }
+
+uint8_t CpuOptions::GetDataTypeSize() const {
+  uint8_t result{0};
+  if (data_type_set_) {
+    switch (data_type_) {
+      case kCpuInt8:
+      case kCpuUint8:
+      case kCpuText:
+        result = 1;
+        break;
+      case kCpuInt16:
+      case kCpuUint16:
+      case kCpuFloat16:
+      case kCpuBfloat16:
+        result = 2;
+        break;
+      case kCpuInt32:
+      case kCpuUint32:
+      case kCpuFloat32:
+        result = 4;
+        break;
+      case kCpuInt64:
+      case kCpuUint64:
+      case kCpuFloat64:
+        result = 8;
+        break;
+      default:
+        break;
+    }
+  }
+  return result;
+}
+
 CpuOptions::CpuOptions() {
   compression_level_ = 0;
   compression_level_set_ = false;
@@ -89,6 +157,13 @@ CpuOptions::CpuOptions() {
   number_threads_set_ = false;
   back_reference_ = 0;
   back_reference_set_ = false;
+  filter_ = 0;
+  filter_set_ = false;
+  element_size_ = 0;
+  element_size_set_ = false;
+  data_type_ = 0;
+  data_type_set_ = false;
+  shape_set_ = false;
 }
 
 CpuOptions::~CpuOptions() {}
@@ -7,15 +7,18 @@
  */
 
 // CPU-SMASH LIBRARIES
+#include <cpu_chain.hpp>
 #include <cpu_compression_libraries.hpp>
 #include <cpu_smash.hpp>
 
 bool CpuSmash::SetOptionsCompressor(CpuOptions *options) {
-  return lib->SetOptionsCompressor(options);
+  return SetFilterOptions(options) &&
+         lib->SetOptionsCompressor(options);
 }
 
 bool CpuSmash::SetOptionsDecompressor(CpuOptions *options) {
-  return lib->SetOptionsDecompressor(options);
+  return SetFilterOptions(options) &&
+         lib->SetOptionsDecompressor(options);
 }
 
 void CpuSmash::GetCompressedDataSize(const char *const uncompressed_data,
@@ -28,8 +31,13 @@ void CpuSmash::GetCompressedDataSize(const char *const uncompressed_data,
 bool CpuSmash::Compress(const char *const uncompressed_data,
                         const uint64_t &uncompressed_data_size,
                         char *compressed_data, uint64_t *compressed_data_size) {
-  return lib->Compress(uncompressed_data, uncompressed_data_size,
-                       compressed_data, compressed_data_size);
+  return CompressFiltered(
+      lib->GetOptions(), uncompressed_data, uncompressed_data_size,
+      compressed_data, compressed_data_size, lib->IsStateless(),
+      [this](const char *const data, const uint64_t &data_size, char *output,
+             uint64_t *output_size) {
+        return lib->Compress(data, data_size, output, output_size);
+      });
 }
 
 void CpuSmash::GetDecompressedDataSize(const char *const compressed_data,
@@ -43,9 +51,59 @@ bool CpuSmash::Decompress(const char *const compressed_data,
                           const uint64_t &compressed_data_size,
                           char *decompressed_data,
                           uint64_t *decompressed_data_size) {
-  return lib->Decompress(compressed_data, compressed_data_size,
-                         decompressed_data, decompressed_data_size);
-}
+  return DecompressFiltered(
+      decompressed_data, decompressed_data_size,
+      [&](char *output, uint64_t *output_size) {
+        return lib->Decompress(compressed_data, compressed_data_size, output,
+                               output_size);
+      });
+}
+
+bool CpuSmash::CompressAgainst(const char *const reference_data,
+                               const uint64_t &reference_data_size,
+                               const char *const uncompressed_data,
+                               const uint64_t &uncompressed_data_size,
+                               char *compressed_data,
+                               uint64_t *compressed_data_size) {
+  return CompressAgainstFiltered(
+      reference_data, reference_data_size, uncompressed_data,
+      uncompressed_data_size, compressed_data, compressed_data_size,
+      [this](const char *const reference, const uint64_t &reference_size,
+             const char *const data, const uint64_t &data_size, char *output,
+             uint64_t *output_size) {
+        return lib->CompressAgainst(reference, reference_size, data,
+                                    data_size, output, output_size);
+      });
+}
+
+bool CpuSmash::DecompressAgainst(const char *const reference_data,
+                                 const uint64_t &reference_data_size,
+                                 const char *const compressed_data,
+                                 const uint64_t &compressed_data_size,
+                                 char *decompressed_data,
+                                 uint64_t *decompressed_data_size) {
+  return DecompressAgainstFiltered(
+      reference_data, reference_data_size, decompressed_data,
+      decompressed_data_size,
+      [&](const char *const reference, const uint64_t &reference_size,
+          char *output, uint64_t *output_size) {
+        return lib->DecompressAgainst(reference, reference_size,
+                                      compressed_data, compressed_data_size,
+                                      output, output_size);
+      });
+}
+
+bool CpuSmash::Sink(const char *const data, const uint64_t &data_size,
+                    uint64_t *sunk_data_size) {
+  return CheckSink(sunk_data_size) &&
+         lib->Sink(data, data_size, sunk_data_size);
+}
+
+bool CpuSmash::Poll(char *data, uint64_t *data_size, bool *more_data) {
+  return lib->Poll(data, data_size, more_data);
+}
+
+bool CpuSmash::Finish(bool *finished) { return lib->Finish(finished); }
 
 void CpuSmash::GetTitle() { lib->GetTitle(); }
 
@@ -111,15 +169,52 @@ std::string CpuSmash::GetModeName(const uint8_t &mode) {
   return lib->GetModeName(mode);
 }
 
+bool CpuSmash::GetFilterInformation(
+    std::vector<std::string> *filter_information, uint8_t *minimum_filter,
+    uint8_t *maximum_filter) {
+  return filter_.GetFilterInformation(filter_information, minimum_filter,
+                                      maximum_filter);
+}
+
+bool CpuSmash::GetElementSizeInformation(
+    std::vector<std::string> *element_size_information, uint8_t *minimum_size,
+    uint8_t *maximum_size) {
+  return filter_.GetElementSizeInformation(element_size_information,
+                                           minimum_size, maximum_size);
+}
+
 std::string CpuSmash::GetFlagsName(const uint8_t &flags) {
   return lib->GetFlagsName(flags);
 }
 
+std::string CpuSmash::GetFilterName(const uint8_t &filter) {
+  return filter_.GetFilterName(filter);
+}
+
 CpuOptions CpuSmash::GetOptions() { return lib->GetOptions(); }
 
-CpuSmash::CpuSmash(const std::string &compression_library_name) {
-  lib =
-      CpuCompressionLibraries().GetCompressionLibrary(compression_library_name);
+CpuSmash::CpuSmash(const std::string &compression_library_name,
+                   const bool &pooled)
+    : CpuSmashCommon(compression_library_name),
+      library_id_(0),
+      pooled_(pooled) {
+  CpuCompressionLibraries libraries;
+  if (!libraries.GetLibraryId(compression_library_name, &library_id_)) {
+    // Any other name is a chain, even with one stage (e.g., "delta8", "huf"
+    // or "zero(lz4)"). Chains are not pooled, and invalid chains exit
+    pooled_ = false;
+    lib = new CpuChain(compression_library_name);
+  } else if (pooled_) {
+    lib = libraries.CheckOutCompressionLibrary(library_id_);
+  } else {
+    lib = libraries.GetCompressionLibrary(library_id_);
+  }
+}
+
+CpuSmash::~CpuSmash() {
+  if (pooled_) {
+    CpuCompressionLibraries().ReturnCompressionLibrary(library_id_, lib);
+  } else {
+    delete lib;
+  }
 }
-
-CpuSmash::~CpuSmash() { delete lib; }
@@ -0,0 +1,46 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_libraries.hpp>
+#include <cpu_smash_common.hpp>
+
+bool CpuSmashCommon::SetFilterOptions(CpuOptions *options) {
+  return filter_.SetOptions(options) && reference_filter_.SetOptions(options);
+}
+
+bool CpuSmashCommon::CheckSink(uint64_t *sunk_data_size) {
+  bool result{!filter_.IsSet()};
+  if (!result) {
+    std::cout << "ERROR: Filters are not available in incremental mode"
+              << std::endl;
+    *sunk_data_size = 0;
+  }
+  return result;
+}
+
+void CpuSmashCommon::CheckLibraryName(const std::type_info &type) {
+  CpuCompressionLibraries libraries;
+  uint16_t library_id{0};
+  bool result{libraries.GetLibraryId(name_, &library_id)};
+  if (result) {
+    // A pooled instance, so only the first check creates the library
+    CpuCompressionLibrary *library =
+        libraries.CheckOutCompressionLibrary(library_id);
+    result = typeid(*library) == type;
+    libraries.ReturnCompressionLibrary(library_id, library);
+  }
+  if (!result) {
+    std::cout << "ERROR: The compression library " << name_
+              << " does not exist or it is not the library of CpuSmashT"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+CpuSmashCommon::CpuSmashCommon(const std::string &name) : name_(name) {}
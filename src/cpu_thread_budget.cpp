@@ -0,0 +1,56 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <mutex>
+#include <thread>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_thread_budget.hpp>
+
+static std::mutex budget_mutex;
+static uint32_t budget_maximum_threads{std::thread::hardware_concurrency()};
+static uint32_t budget_used_threads{0};
+
+void CpuThreadBudget::SetMaximumThreads(const uint32_t &maximum_threads) {
+  std::lock_guard<std::mutex> lock(budget_mutex);
+  budget_maximum_threads = maximum_threads;
+}
+
+uint32_t CpuThreadBudget::GetMaximumThreads() {
+  std::lock_guard<std::mutex> lock(budget_mutex);
+  return budget_maximum_threads;
+}
+
+uint32_t CpuThreadBudget::GetUsedThreads() {
+  std::lock_guard<std::mutex> lock(budget_mutex);
+  return budget_used_threads;
+}
+
+uint32_t CpuThreadBudget::AcquireThreads(const uint32_t &number_threads) {
+  uint32_t threads{0};
+  if (number_threads > 1) {
+    std::lock_guard<std::mutex> lock(budget_mutex);
+    threads = number_threads - 1;
+    if (budget_maximum_threads) {
+      uint32_t available_threads{0};
+      if (budget_used_threads < budget_maximum_threads) {
+        available_threads = budget_maximum_threads - budget_used_threads;
+      }
+      if (threads > available_threads) threads = available_threads;
+    }
+    budget_used_threads += threads;
+  }
+  return threads + 1;
+}
+
+void CpuThreadBudget::ReleaseThreads(const uint32_t &number_threads) {
+  if (number_threads > 1) {
+    std::lock_guard<std::mutex> lock(budget_mutex);
+    budget_used_threads -= number_threads - 1;
+  }
+}
@@ -0,0 +1,188 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_thread_pool.hpp>
+
+// hardware_concurrency is 0 when it is not known
+static uint32_t GetHardwareThreads() {
+  uint32_t hardware_threads{std::thread::hardware_concurrency()};
+  return (hardware_threads) ? hardware_threads : 1;
+}
+
+struct CpuThreadPoolQueue {
+  std::mutex mutex;
+  std::deque<std::function<void()>> tasks;
+};
+
+class CpuThreadPoolState {
+ public:
+  // Protects the queues and threads against SetNumberThreads
+  std::mutex mutex;
+  std::vector<std::unique_ptr<CpuThreadPoolQueue>> queues;
+  std::vector<std::thread> threads;
+  uint32_t number_threads{GetHardwareThreads()};
+  bool pin_threads{false};
+  bool started{false};
+
+  std::mutex sleep_mutex;
+  std::condition_variable condition;
+  std::atomic<uint64_t> pending_tasks{0};
+  bool stop{false};
+
+  std::atomic<uint64_t> next_queue{0};
+
+  void Start();
+  void Stop();
+  bool Pop(const uint64_t &first_queue, std::function<void()> *task);
+  void Work(const uint64_t &index);
+
+  ~CpuThreadPoolState() { Stop(); }
+};
+
+static CpuThreadPoolState pool;
+// Queue of the pool thread, or -1 in any other thread
+static thread_local int64_t pool_index{-1};
+
+void CpuThreadPoolState::Start() {
+  if (!started) {
+    stop = false;
+    queues.clear();
+    // At least one queue, even without threads, where the calling threads
+    // take the tasks from
+    for (uint32_t i = 0; i < number_threads || i == 0; ++i) {
+      queues.emplace_back(new CpuThreadPoolQueue);
+    }
+    for (uint32_t i = 0; i < number_threads; ++i) {
+      threads.emplace_back(&CpuThreadPoolState::Work, this, i);
+#ifdef __linux__
+      if (pin_threads) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(i % GetHardwareThreads(), &cpu_set);
+        pthread_setaffinity_np(threads.back().native_handle(),
+                               sizeof(cpu_set), &cpu_set);
+      }
+#endif  // __linux__
+    }
+    started = true;
+  }
+}
+
+void CpuThreadPoolState::Stop() {
+  if (started) {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stop = true;
+    }
+    condition.notify_all();
+    // Threads end when there are no more pending tasks
+    for (auto &thread : threads) thread.join();
+    threads.clear();
+    started = false;
+  }
+}
+
+bool CpuThreadPoolState::Pop(const uint64_t &first_queue,
+                             std::function<void()> *task) {
+  bool result{false};
+  uint64_t number_of_queues = queues.size();
+  for (uint64_t i = 0; !result && i < number_of_queues; ++i) {
+    CpuThreadPoolQueue *queue =
+        queues[(first_queue + i) % number_of_queues].get();
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      // The own queue is used as a stack, the others are stolen in order
+      if (i == 0 && pool_index >= 0) {
+        *task = std::move(queue->tasks.back());
+        queue->tasks.pop_back();
+      } else {
+        *task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+      }
+      --pending_tasks;
+      result = true;
+    }
+  }
+  return result;
+}
+
+void CpuThreadPoolState::Work(const uint64_t &index) {
+  pool_index = index;
+  std::function<void()> task;
+  while (true) {
+    if (Pop(index, &task)) {
+      task();
+    } else {
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      condition.wait(lock, [this] { return stop || pending_tasks > 0; });
+      if (stop && pending_tasks == 0) break;
+    }
+  }
+}
+
+void CpuThreadPool::SetNumberThreads(const uint32_t &number_threads,
+                                     const bool &pin_threads) {
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.Stop();
+  pool.number_threads = number_threads;
+  pool.pin_threads = pin_threads;
+}
+
+uint32_t CpuThreadPool::GetNumberThreads() {
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  return pool.number_threads;
+}
+
+void CpuThreadPool::Submit(const std::function<void()> &task) {
+  uint64_t index{0};
+  if (pool_index >= 0) {
+    index = pool_index;
+  } else {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.Start();
+    index = pool.next_queue++ % pool.queues.size();
+  }
+  {
+    // Counted before it is queued, so it can not be taken before
+    std::lock_guard<std::mutex> lock(pool.sleep_mutex);
+    ++pool.pending_tasks;
+  }
+  {
+    CpuThreadPoolQueue *queue = pool.queues[index].get();
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.push_back(task);
+  }
+  pool.condition.notify_one();
+}
+
+bool CpuThreadPool::RunPendingTask() {
+  bool result{false};
+  std::function<void()> task;
+  if (pool_index >= 0) {
+    result = pool.Pop(pool_index, &task);
+  } else {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    result = pool.started && pool.Pop(pool.next_queue, &task);
+  }
+  if (result) task();
+  return result;
+}
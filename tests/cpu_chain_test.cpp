@@ -0,0 +1,176 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_options.hpp>
+#include <cpu_smash.hpp>
+
+namespace {
+
+// Data with repetitions, so every stage has something to compress
+std::vector<char> GetData(const uint64_t &data_size) {
+  std::vector<char> data(data_size);
+  for (uint64_t i = 0; i < data_size; ++i) {
+    data[i] = (i % 64 < 32) ? 0 : static_cast<char>((i * 13) % 97);
+  }
+  return data;
+}
+
+// Compresses the data with a new compressor of the chain
+bool GetFrame(const std::string &chain, const std::vector<char> &data,
+              std::vector<char> *frame) {
+  CpuOptions options;
+  CpuSmash compressor(chain);
+  bool result = compressor.SetOptionsCompressor(&options);
+  uint64_t compressed_data_size{0};
+  compressor.GetCompressedDataSize(data.data(), data.size(),
+                                   &compressed_data_size);
+  frame->resize(compressed_data_size);
+  if (result) {
+    result = compressor.Compress(data.data(), data.size(), frame->data(),
+                                 &compressed_data_size);
+    frame->resize(compressed_data_size);
+  }
+  return result;
+}
+
+#ifdef QUICKLZ
+bool RoundTrip(const std::string &chain, const uint64_t &data_size) {
+  const std::vector<char> data = GetData(data_size);
+  CpuOptions options;
+  CpuSmash compressor(chain);
+  bool result = compressor.SetOptionsCompressor(&options);
+  uint64_t compressed_data_size{0};
+  compressor.GetCompressedDataSize(data.data(), data_size,
+                                   &compressed_data_size);
+  std::vector<char> compressed_data(compressed_data_size);
+  if (result) {
+    result = compressor.Compress(data.data(), data_size,
+                                 compressed_data.data(), &compressed_data_size);
+  }
+  CpuSmash decompressor(chain);
+  if (result) result = decompressor.SetOptionsDecompressor(&options);
+  std::vector<char> decompressed_data(data_size);
+  uint64_t decompressed_data_size{data_size};
+  if (result) {
+    result = decompressor.Decompress(compressed_data.data(),
+                                     compressed_data_size,
+                                     decompressed_data.data(),
+                                     &decompressed_data_size) &&
+             decompressor.CompareData(data.data(), data_size,
+                                      decompressed_data.data(),
+                                      decompressed_data_size);
+  }
+  if (!result) {
+    std::cout << "ERROR: The chain " << chain << " failed with "
+              << data_size << " bytes" << std::endl;
+  }
+  return result;
+}
+#endif  // QUICKLZ
+
+// A decompressor that fails with a chain that does not exist keeps working
+bool InvalidFrames() {
+  const std::vector<char> data(1000, 7);
+  std::vector<char> frame;
+  bool result = GetFrame("delta4", data, &frame);
+  // Same frame with an unknown stage, and with an empty chain
+  std::vector<char> unknown_frame(frame);
+  unknown_frame[1] = 'x';
+  std::vector<char> empty_frame(1 + sizeof(uint64_t), 0);
+  empty_frame.insert(empty_frame.end(), data.begin(), data.end());
+  CpuOptions options;
+  CpuSmash decompressor("delta4");
+  if (result) result = decompressor.SetOptionsDecompressor(&options);
+  std::vector<char> decompressed_data(data.size());
+  uint64_t decompressed_data_size{data.size()};
+  for (const auto *invalid_frame : {&unknown_frame, &empty_frame}) {
+    if (result) {
+      result = !decompressor.Decompress(
+          invalid_frame->data(), invalid_frame->size(),
+          decompressed_data.data(), &decompressed_data_size);
+    }
+  }
+  decompressed_data_size = data.size();
+  if (result) {
+    result = decompressor.Decompress(frame.data(), frame.size(),
+                                     decompressed_data.data(),
+                                     &decompressed_data_size) &&
+             decompressor.CompareData(data.data(), data.size(),
+                                      decompressed_data.data(),
+                                      decompressed_data_size);
+  }
+  if (!result) {
+    std::cout << "ERROR: The invalid frames of a chain failed" << std::endl;
+  }
+  return result;
+}
+
+#if defined(ZERO) && defined(PLANES)
+// One decompressor takes the chain of every frame, even when it is not the
+// one it was created with, and goes back to it
+bool Frames() {
+  CpuOptions options;
+  CpuSmash decompressor("delta4");
+  const bool result = decompressor.SetOptionsDecompressor(&options);
+  bool frames_result{result};
+  for (const auto &chain : {"xor4|zero", "shuffle2|planes", "delta4",
+                            "bitshuffle8|zero:1|delta1", "dod2|zero"}) {
+    for (const uint64_t data_size : {1, 1001, 100003}) {
+      const std::vector<char> data = GetData(data_size);
+      std::vector<char> frame;
+      uint64_t decompressed_data_size{0};
+      bool frame_result = result && GetFrame(chain, data, &frame);
+      if (frame_result) {
+        decompressor.GetDecompressedDataSize(frame.data(), frame.size(),
+                                             &decompressed_data_size);
+        frame_result = decompressed_data_size == data_size;
+      }
+      std::vector<char> decompressed_data(data_size);
+      if (frame_result) {
+        frame_result = decompressor.Decompress(frame.data(), frame.size(),
+                                               decompressed_data.data(),
+                                               &decompressed_data_size) &&
+                       decompressor.CompareData(data.data(), data_size,
+                                                decompressed_data.data(),
+                                                decompressed_data_size);
+      }
+      if (!frame_result) {
+        std::cout << "ERROR: The frame of the chain " << chain << " with "
+                  << data_size << " bytes failed" << std::endl;
+      }
+      frames_result = frame_result && frames_result;
+    }
+  }
+  return frames_result;
+}
+#endif  // ZERO && PLANES
+
+}  // namespace
+
+int main(int argc, char const *argv[]) {
+  bool result{InvalidFrames()};
+#if defined(ZERO) && defined(PLANES)
+  result = Frames() && result;
+#endif  // ZERO && PLANES
+#ifdef QUICKLZ
+  // The intermediate buffers are sized without reading the data. quicklz
+  // does not take empty data
+  for (const auto &chain : {"quicklz|quicklz", "delta4|quicklz|quicklz:1"}) {
+    for (const uint64_t data_size : {1, 1000, 100003}) {
+      if (!RoundTrip(chain, data_size)) result = false;
+    }
+  }
+#endif  // QUICKLZ
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
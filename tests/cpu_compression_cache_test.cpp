@@ -0,0 +1,89 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_compression_cache.hpp>
+#include <cpu_options.hpp>
+#include <cpu_smash.hpp>
+
+#ifdef QUICKLZ
+namespace {
+
+const uint64_t kDataSize{64 * 1024};
+const uint8_t kMessages{3};
+
+// Compresses the same data several times with the cache enabled, and
+// decompresses the messages in the same order
+bool RoundTrip(const uint8_t &mode, uint64_t *hits) {
+  CpuOptions options;
+  options.SetMode(mode);
+  std::vector<char> data(kDataSize);
+  for (uint64_t i = 0; i < kDataSize; ++i) data[i] = (i * 7) % 251;
+  CpuCompressionCache::Clear();
+  CpuCompressionCache::SetMaximumSize(16 * kDataSize);
+
+  CpuSmash compressor("quicklz");
+  bool result = compressor.SetOptionsCompressor(&options);
+  // With data, quicklz reads the size of compressed data
+  uint64_t compressed_data_size{0};
+  compressor.GetCompressedDataSize(nullptr, kDataSize, &compressed_data_size);
+  std::vector<std::vector<char>> messages;
+  for (uint8_t i = 0; result && i < kMessages; ++i) {
+    messages.emplace_back(compressed_data_size);
+    uint64_t message_size{compressed_data_size};
+    result = compressor.Compress(data.data(), kDataSize, messages[i].data(),
+                                 &message_size);
+    messages[i].resize(message_size);
+  }
+  *hits = CpuCompressionCache::GetHits();
+
+  CpuSmash decompressor("quicklz");
+  if (result) result = decompressor.SetOptionsDecompressor(&options);
+  std::vector<char> decompressed_data(kDataSize);
+  for (uint8_t i = 0; result && i < kMessages; ++i) {
+    uint64_t decompressed_data_size{kDataSize};
+    result = decompressor.Decompress(messages[i].data(), messages[i].size(),
+                                     decompressed_data.data(),
+                                     &decompressed_data_size) &&
+             decompressor.CompareData(data.data(), kDataSize,
+                                      decompressed_data.data(),
+                                      decompressed_data_size);
+  }
+  CpuCompressionCache::SetMaximumSize(0);
+  return result;
+}
+
+}  // namespace
+#endif  // QUICKLZ
+
+int main(int argc, char const *argv[]) {
+  bool result{true};
+#ifdef QUICKLZ
+  uint64_t hits{0};
+  // Independent messages are taken from the cache
+  if (!RoundTrip(0, &hits) || hits != kMessages - 1) {
+    std::cout << "ERROR: quicklz mode 0 with the cache failed (" << hits
+              << " hits)" << std::endl;
+    result = false;
+  }
+  // The session mode has to compress every message, or the decompressor
+  // loses the history
+  if (!RoundTrip(1, &hits) || hits != 0) {
+    std::cout << "ERROR: quicklz mode 1 with the cache failed (" << hits
+              << " hits)" << std::endl;
+    result = false;
+  }
+#else
+  std::cout << "quicklz is not available, the test is skipped" << std::endl;
+#endif  // QUICKLZ
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_dedup.hpp>
+#include <cpu_options.hpp>
+
+#ifdef ZERO
+namespace {
+
+const uint64_t kChunkSize{1024};
+const uint32_t kCacheChunks{4};
+
+// Every chunk is named by a letter, and a lowercase letter is a short chunk
+std::vector<char> GetMessage(const std::string &chunks) {
+  std::vector<char> message;
+  for (const char &chunk : chunks) {
+    const uint64_t size = (chunk >= 'a') ? kChunkSize / 10 : kChunkSize;
+    for (uint64_t i = 0; i < size; ++i) {
+      message.push_back((i % 4) ? 0 : static_cast<char>(chunk + i * 7));
+    }
+  }
+  return message;
+}
+
+// Sends the messages in order and checks the duplicated chunks of every one,
+// which are the same in both sides
+bool Messages(const std::vector<std::string> &messages,
+              const std::vector<uint64_t> &duplicated_chunks) {
+  CpuOptions options;
+  CpuDedup compressor("zero", kChunkSize, kCacheChunks);
+  CpuDedup decompressor("zero", kChunkSize, kCacheChunks);
+  bool result = compressor.SetOptionsCompressor(&options) &&
+                decompressor.SetOptionsDecompressor(&options);
+  for (uint64_t i = 0; result && i < messages.size(); ++i) {
+    const std::vector<char> data = GetMessage(messages[i]);
+    const uint64_t compressor_chunks = compressor.GetDuplicatedChunks();
+    const uint64_t decompressor_chunks = decompressor.GetDuplicatedChunks();
+    uint64_t compressed_data_size{0};
+    compressor.GetCompressedDataSize(data.data(), data.size(),
+                                     &compressed_data_size);
+    std::vector<char> compressed_data(compressed_data_size);
+    std::vector<char> decompressed_data(data.size());
+    uint64_t decompressed_data_size{data.size()};
+    result = compressor.Compress(data.data(), data.size(),
+                                 compressed_data.data(),
+                                 &compressed_data_size) &&
+             decompressor.Decompress(compressed_data.data(),
+                                     compressed_data_size,
+                                     decompressed_data.data(),
+                                     &decompressed_data_size) &&
+             decompressed_data_size == data.size() &&
+             decompressed_data == data &&
+             compressor.GetDuplicatedChunks() - compressor_chunks ==
+                 duplicated_chunks[i] &&
+             decompressor.GetDuplicatedChunks() - decompressor_chunks ==
+                 duplicated_chunks[i];
+    if (!result) {
+      std::cout << "ERROR: The dedup message " << messages[i] << " failed"
+                << std::endl;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+#endif  // ZERO
+
+int main(int argc, char const *argv[]) {
+  bool result{true};
+#ifdef ZERO
+  // A chunk repeated within one message, and a short last chunk that is
+  // never in the cache
+  result = Messages({"ABACa", "a"}, {1, 0}) && result;
+  // The cache holds 4 chunks: E replaces A, and A then replaces B, so only
+  // D is still there
+  result = Messages({"ABC", "ABCDE", "ABD"}, {0, 3, 1}) && result;
+#else
+  std::cout << "zero is not available, the test is skipped" << std::endl;
+#endif  // ZERO
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,124 @@
+/*
+ * rCUDA: remote CUDA (www.rCUDA.net)
+ * Copyright (C) 2016-2022
+ * Grupo de Arquitecturas Paralelas
+ * Departamento de Informática de Sistemas y Computadores
+ * Universidad Politécnica de Valencia (Spain)
+ */
+
+#include <string.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// CPU-SMASH LIBRARIES
+#include <cpu_filter.hpp>
+#include <cpu_options.hpp>
+
+namespace {
+
+// Sizes that are not multiples of the SIMD blocks, so the generic versions
+// process the last elements
+const uint64_t kDataSizes[] = {1, 15, 17, 100, 1001, 4099};
+const uint8_t kElementSizes[] = {1, 2, 3, 4, 8, 16};
+
+// Elements that change slowly, as the data the filters are made for
+std::vector<uint8_t> GetData(const uint64_t &data_size) {
+  std::vector<uint8_t> data(data_size);
+  for (uint64_t i = 0; i < data_size; ++i) {
+    data[i] = static_cast<uint8_t>((i / 7) * 3 + ((i * 13) % 5));
+  }
+  return data;
+}
+
+// Compares the filtered data with the generic definition of the filter,
+// when it is simple enough
+bool CheckFilteredData(const uint8_t &filter, const uint8_t &element_size,
+                       const uint8_t *data, const uint64_t &data_size,
+                       const uint8_t *filtered_data) {
+  uint64_t elements = data_size / element_size;
+  // The bit shuffle only takes blocks of 8 elements
+  if (filter == 2) elements &= ~7ULL;
+  bool result{true};
+  for (uint64_t i = 0; result && i < elements * element_size; ++i) {
+    const uint64_t element = i / element_size;
+    const uint64_t byte = i % element_size;
+    if (filter == 1) {
+      result = filtered_data[byte * elements + element] == data[i];
+    } else if (filter == 3) {
+      result = filtered_data[i] ==
+               ((element) ? data[i] ^ data[i - element_size] : data[i]);
+    }
+  }
+  // The bytes of the last incomplete element are not modified
+  const uint64_t tail = elements * element_size;
+  return result && memcmp(filtered_data + tail, data + tail,
+                          data_size - tail) == 0;
+}
+
+// Applies and reverts the filter on buffers that are not aligned
+bool RoundTrip(const uint8_t &filter, const uint8_t &element_size,
+               const uint64_t &data_size) {
+  const std::vector<uint8_t> data = GetData(data_size);
+  std::vector<uint8_t> source(data_size + 1);
+  memcpy(source.data() + 1, data.data(), data_size);
+  CpuOptions options;
+  options.SetFilter(filter);
+  options.SetElementSize(element_size);
+  CpuFilter cpu_filter;
+  bool result = cpu_filter.SetOptions(&options);
+  if (result) {
+    const uint8_t *filtered_data =
+        reinterpret_cast<const uint8_t *>(cpu_filter.Apply(
+            reinterpret_cast<const char *>(source.data() + 1), data_size));
+    result = CheckFilteredData(filter, element_size, data.data(), data_size,
+                               filtered_data);
+    std::vector<uint8_t> reverted_data(data_size + 3);
+    memcpy(reverted_data.data() + 3, filtered_data, data_size);
+    cpu_filter.Revert(reinterpret_cast<char *>(reverted_data.data() + 3),
+                      data_size);
+    result = result && memcmp(reverted_data.data() + 3, data.data(),
+                              data_size) == 0;
+  }
+  if (!result) {
+    std::cout << "ERROR: The filter " << static_cast<uint64_t>(filter)
+              << " failed with element size "
+              << static_cast<uint64_t>(element_size) << " and " << data_size
+              << " bytes" << std::endl;
+  }
+  return result;
+}
+
+// The integer filters only take the sizes of the integer types
+bool RejectsElementSize(const uint8_t &filter, const uint8_t &element_size) {
+  CpuOptions options;
+  options.SetFilter(filter);
+  options.SetElementSize(element_size);
+  CpuFilter cpu_filter;
+  const bool result = !cpu_filter.SetOptions(&options);
+  if (!result) {
+    std::cout << "ERROR: The filter " << static_cast<uint64_t>(filter)
+              << " took element size " << static_cast<uint64_t>(element_size)
+              << std::endl;
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char const *argv[]) {
+  bool result{true};
+  for (const uint8_t filter : {1, 2, 3, 4, 5}) {
+    for (const uint8_t &element_size : kElementSizes) {
+      if (filter >= 4 && (element_size == 3 || element_size == 16)) {
+        result = RejectsElementSize(filter, element_size) && result;
+      } else {
+        for (const uint64_t &data_size : kDataSizes) {
+          result = RoundTrip(filter, element_size, data_size) && result;
+        }
+      }
+    }
+  }
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}